@@ -0,0 +1,444 @@
+/*
+MIT License
+
+Copyright (c) 2018 Roberto Bender
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+getopt/getopt_long compatible entry points. The declarations below can be
+used from C and C++; exactly one C++ translation unit must define
+CLI_GETOPT_IMPLEMENTATION before including this header. Define
+CLI_GETOPT_REPLACE to map the standard getopt names onto this implementation;
+<unistd.h> and <getopt.h> may then be included before or after this header.
+*/
+
+#ifndef CLI_GETOPT_H
+#define CLI_GETOPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct cli_option
+{
+    const char* name;
+    int has_arg;
+    int* flag;
+    int val;
+};
+
+#define cli_no_argument 0
+#define cli_required_argument 1
+#define cli_optional_argument 2
+
+extern char* cli_optarg;
+extern int cli_optind;
+extern int cli_opterr;
+extern int cli_optopt;
+
+int cli_getopt(int argc, char* const argv[], const char* optstring);
+int cli_getopt_long(int argc, char* const argv[], const char* optstring, const struct cli_option* longopts, int* longindex);
+
+#ifdef __cplusplus
+}
+#endif
+
+// The system declarations are seen before the renaming macros below, so
+// they keep their own names and are not declared again by a later include.
+#ifdef CLI_GETOPT_REPLACE
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if defined(__has_include)
+#if __has_include(<getopt.h>)
+#include <getopt.h>
+#endif
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <getopt.h>
+#endif
+#endif
+
+#endif
+
+#if defined(CLI_GETOPT_IMPLEMENTATION) && !defined(CLI_GETOPT_IMPLEMENTED)
+#define CLI_GETOPT_IMPLEMENTED
+
+#include "cli_parser.h"
+
+char* cli_optarg = nullptr;
+int cli_optind = 1;
+int cli_opterr = 1;
+int cli_optopt = '?';
+
+namespace cli
+{
+    // Scanning state shared by the cli_getopt* entry points. Long option names
+    // are looked up in the parser's HashIndex; only a miss falls back to the
+    // ordered map that resolves unambiguous prefixes. Both indexes are rebuilt
+    // whenever a new scan starts or the optstring contents change, so reused
+    // buffers and rebuilt tables are never matched against stale entries.
+    class GetoptState
+    {
+    public:
+        static GetoptState& instance()
+        {
+            static GetoptState state;
+            return state;
+        }
+
+        int next(int argc, char* const argv[], const char* optstring, const cli_option* longopts, int* longindex)
+        {
+            if (cli_optind == 0 || !mInitialized)
+            {
+                if (cli_optind == 0)
+                    cli_optind = 1;
+                mNextChar = nullptr;
+                mFirstNonopt = mLastNonopt = cli_optind;
+                mInitialized = true;
+            }
+
+            bool restart = cli_optind <= 1 && (mNextChar == nullptr || *mNextChar == '\0');
+            indexShort(optstring, restart);
+            indexLong(longopts, restart);
+
+            bool silent = optstring[0] == ':' || ((optstring[0] == '+' || optstring[0] == '-') && optstring[1] == ':');
+            cli_optarg = nullptr;
+
+            if (mNextChar == nullptr || *mNextChar == '\0')
+            {
+                int result = 0;
+                if (!advance(argc, argv, result))
+                    return result;
+
+                const char* arg = argv[cli_optind];
+                if (longopts != nullptr && arg[1] == '-')
+                    return matchLong(argc, argv, longopts, longindex, silent);
+
+                mNextChar = arg + 1;
+            }
+
+            return matchShort(argc, argv, silent);
+        }
+
+    private:
+        enum Ordering
+        {
+            PERMUTE,
+            REQUIRE_ORDER,
+            RETURN_IN_ORDER,
+        };
+
+        bool mInitialized;
+        const char* mNextChar;
+        int mFirstNonopt;
+        int mLastNonopt;
+        Ordering mOrdering;
+        const char* mShortSource;
+        std::string mShortText;
+        signed char mShort[256];
+        const cli_option* mLongSource;
+        HashIndex<int> mLongExact;
+        std::map<std::string, int> mLong;
+
+        GetoptState()
+            : mInitialized(false)
+            , mNextChar(nullptr)
+            , mFirstNonopt(1)
+            , mLastNonopt(1)
+            , mOrdering(PERMUTE)
+            , mShortSource(nullptr)
+            , mLongSource(nullptr)
+        {
+        }
+
+        static bool isOption(const char* arg)
+        {
+            return arg[0] == '-' && arg[1] != '\0';
+        }
+
+        void indexShort(const char* optstring, bool restart)
+        {
+            if (!restart && optstring == mShortSource && mShortText == optstring)
+                return;
+
+            mShortSource = optstring;
+            mShortText = optstring;
+            mOrdering = PERMUTE;
+            if (*optstring == '+' || std::getenv("POSIXLY_CORRECT") != nullptr)
+                mOrdering = REQUIRE_ORDER;
+            if (*optstring == '-')
+                mOrdering = RETURN_IN_ORDER;
+            if (*optstring == '+' || *optstring == '-')
+                ++optstring;
+            if (*optstring == ':')
+                ++optstring;
+
+            std::memset(mShort, -1, sizeof(mShort));
+            for (; *optstring != '\0'; ++optstring)
+            {
+                unsigned char c = static_cast<unsigned char>(*optstring);
+                if (c == ':')
+                    continue;
+
+                mShort[c] = cli_no_argument;
+                if (optstring[1] == ':')
+                    mShort[c] = optstring[2] == ':' ? cli_optional_argument : cli_required_argument;
+            }
+        }
+
+        void indexLong(const cli_option* longopts, bool restart)
+        {
+            if (!restart && longopts == mLongSource)
+                return;
+
+            mLongSource = longopts;
+            mLongExact = HashIndex<int>();
+            mLong.clear();
+            for (int i = 0; longopts != nullptr && longopts[i].name != nullptr; ++i)
+            {
+                // Values are stored one-based, since a miss returns int().
+                if (mLongExact.find(longopts[i].name) == 0)
+                    mLongExact.insert(longopts[i].name, i + 1);
+                mLong.insert(std::make_pair(std::string(longopts[i].name), i));
+            }
+        }
+
+        // Moves the non-options skipped so far behind the options processed
+        // after them, keeping the relative order of both groups (GNU ordering).
+        void exchange(char* const argv[])
+        {
+            char** args = const_cast<char**>(argv);
+            std::rotate(args + mFirstNonopt, args + mLastNonopt, args + cli_optind);
+            mFirstNonopt += cli_optind - mLastNonopt;
+            mLastNonopt = cli_optind;
+        }
+
+        bool advance(int argc, char* const argv[], int& result)
+        {
+            if (mLastNonopt > cli_optind)
+                mLastNonopt = cli_optind;
+            if (mFirstNonopt > cli_optind)
+                mFirstNonopt = cli_optind;
+
+            if (mOrdering == PERMUTE)
+            {
+                if (mFirstNonopt != mLastNonopt && mLastNonopt != cli_optind)
+                    exchange(argv);
+                else if (mLastNonopt != cli_optind)
+                    mFirstNonopt = cli_optind;
+
+                while (cli_optind < argc && !isOption(argv[cli_optind]))
+                    ++cli_optind;
+                mLastNonopt = cli_optind;
+            }
+
+            if (cli_optind != argc && std::strcmp(argv[cli_optind], "--") == 0)
+            {
+                ++cli_optind;
+                if (mFirstNonopt != mLastNonopt && mLastNonopt != cli_optind)
+                    exchange(argv);
+                else if (mFirstNonopt == mLastNonopt)
+                    mFirstNonopt = cli_optind;
+                mLastNonopt = argc;
+                cli_optind = argc;
+            }
+
+            if (cli_optind == argc)
+            {
+                if (mFirstNonopt != mLastNonopt)
+                    cli_optind = mFirstNonopt;
+                result = -1;
+                return false;
+            }
+
+            if (!isOption(argv[cli_optind]))
+            {
+                result = -1;
+                if (mOrdering == RETURN_IN_ORDER)
+                {
+                    cli_optarg = argv[cli_optind++];
+                    result = 1;
+                }
+                return false;
+            }
+
+            return true;
+        }
+
+        int matchLong(int argc, char* const argv[], const cli_option* longopts, int* longindex, bool silent)
+        {
+            const char* arg = argv[cli_optind++];
+            const char* name = arg + 2;
+            const char* equals = std::strchr(name, '=');
+            std::string key = equals != nullptr ? std::string(name, equals) : std::string(name);
+            mNextChar = nullptr;
+
+            int index = mLongExact.find(key) - 1;
+            auto it = mLong.lower_bound(key);
+
+            bool ambiguous = false;
+            for (auto next = it; index < 0 && next != mLong.end() && next->first.compare(0, key.size(), key) == 0; ++next)
+            {
+                const cli_option& a = longopts[it->second];
+                const cli_option& b = longopts[next->second];
+                if (a.has_arg != b.has_arg || a.flag != b.flag || a.val != b.val)
+                    ambiguous = true;
+                if (next->second < it->second)
+                    it = next;
+            }
+            if (index < 0 && it != mLong.end() && it->first.compare(0, key.size(), key) == 0)
+                index = it->second;
+
+            if (ambiguous)
+            {
+                if (cli_opterr && !silent)
+                    std::cerr << "Ambiguous argument {'--" << key << "'}. Please use --help for more information." << std::endl;
+                cli_optopt = 0;
+                return '?';
+            }
+
+            if (index < 0)
+            {
+                if (cli_opterr && !silent)
+                    std::cerr << "Invalid argument {'--" << key << "'}. Please use --help for more information." << std::endl;
+                cli_optopt = 0;
+                return '?';
+            }
+
+            const cli_option& opt = longopts[index];
+            if (equals != nullptr)
+            {
+                if (opt.has_arg == cli_no_argument)
+                {
+                    if (cli_opterr && !silent)
+                        std::cerr << "Parameter '--" << opt.name << "' does not take an argument. Please use --help for more information." << std::endl;
+                    cli_optopt = opt.val;
+                    return '?';
+                }
+                cli_optarg = const_cast<char*>(equals + 1);
+            }
+            else if (opt.has_arg == cli_required_argument)
+            {
+                if (cli_optind >= argc)
+                {
+                    if (cli_opterr && !silent)
+                        std::cerr << "Missing argument for parameter '--" << opt.name << "'. Please use --help for more information." << std::endl;
+                    cli_optopt = opt.val;
+                    return silent ? ':' : '?';
+                }
+                cli_optarg = argv[cli_optind++];
+            }
+
+            if (longindex != nullptr)
+                *longindex = index;
+            if (opt.flag != nullptr)
+            {
+                *opt.flag = opt.val;
+                return 0;
+            }
+            return opt.val;
+        }
+
+        int matchShort(int argc, char* const argv[], bool silent)
+        {
+            unsigned char c = static_cast<unsigned char>(*mNextChar++);
+            bool last = *mNextChar == '\0';
+            int kind = c == ':' ? -1 : mShort[c];
+
+            if (kind < 0)
+            {
+                if (last)
+                    ++cli_optind;
+                if (cli_opterr && !silent)
+                    std::cerr << "Invalid argument {'-" << static_cast<char>(c) << "'}. Please use --help for more information." << std::endl;
+                cli_optopt = c;
+                return '?';
+            }
+
+            if (kind == cli_no_argument)
+            {
+                if (last)
+                    ++cli_optind;
+                return c;
+            }
+
+            if (!last)
+            {
+                cli_optarg = const_cast<char*>(mNextChar);
+                ++cli_optind;
+            }
+            else if (kind == cli_required_argument)
+            {
+                if (cli_optind + 1 >= argc)
+                {
+                    ++cli_optind;
+                    mNextChar = nullptr;
+                    if (cli_opterr && !silent)
+                        std::cerr << "Missing argument for parameter '-" << static_cast<char>(c) << "'. Please use --help for more information." << std::endl;
+                    cli_optopt = c;
+                    return silent ? ':' : '?';
+                }
+                cli_optarg = argv[cli_optind + 1];
+                cli_optind += 2;
+            }
+            else
+            {
+                ++cli_optind;
+            }
+
+            mNextChar = nullptr;
+            return c;
+        }
+    };
+}
+
+extern "C" int cli_getopt(int argc, char* const argv[], const char* optstring)
+{
+    return cli::GetoptState::instance().next(argc, argv, optstring, nullptr, nullptr);
+}
+
+extern "C" int cli_getopt_long(int argc, char* const argv[], const char* optstring, const struct cli_option* longopts, int* longindex)
+{
+    return cli::GetoptState::instance().next(argc, argv, optstring, longopts, longindex);
+}
+
+#endif
+
+// Applied last, so the implementation above is compiled without them.
+#if defined(CLI_GETOPT_REPLACE) && !defined(CLI_GETOPT_REPLACED)
+#define CLI_GETOPT_REPLACED
+#define option cli_option
+#ifndef no_argument
+#define no_argument cli_no_argument
+#endif
+#ifndef required_argument
+#define required_argument cli_required_argument
+#endif
+#ifndef optional_argument
+#define optional_argument cli_optional_argument
+#endif
+#define optarg cli_optarg
+#define optind cli_optind
+#define opterr cli_opterr
+#define optopt cli_optopt
+#define getopt cli_getopt
+#define getopt_long cli_getopt_long
+#endif
@@ -35,11 +35,110 @@ SOFTWARE.
 #include <vector>
 #include <functional>
 #include <exception>
+#include <cstring>
+#include <initializer_list>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <random>
 
 #ifndef CLI_MAX_LINE_WIDTH
 #define CLI_MAX_LINE_WIDTH 80
 #endif
 
+#ifndef CLI_PARALLEL_PARSE_THRESHOLD
+#define CLI_PARALLEL_PARSE_THRESHOLD (1 << 16)
+#endif
+
+#ifndef CLI_PARALLEL_PARSE_CHUNK
+#define CLI_PARALLEL_PARSE_CHUNK (1 << 14)
+#endif
+
+#ifndef CLI_RESPONSE_FILE_CHUNK
+#define CLI_RESPONSE_FILE_CHUNK (1 << 22)
+#endif
+
+#ifndef CLI_RESPONSE_FILE_DEPTH
+#define CLI_RESPONSE_FILE_DEPTH 16
+#endif
+
+#ifndef CLI_MAX_NUMA_NODES
+#define CLI_MAX_NUMA_NODES 64
+#endif
+
+#ifndef CLI_BATCH_BLOCK_SIZE
+#define CLI_BATCH_BLOCK_SIZE (1 << 20)
+#endif
+
+#ifndef CLI_BYTES_ALIGNMENT
+#define CLI_BYTES_ALIGNMENT 64
+#endif
+
+#ifndef CLI_INDEX_MAX_PROBE
+#define CLI_INDEX_MAX_PROBE 16
+#endif
+
+#ifndef CLI_ACCESS_CACHE_SLOTS
+#define CLI_ACCESS_CACHE_SLOTS 64
+#endif
+
+// Define CLI_NO_SIMD to build the scalar fallbacks only.
+#if !defined(CLI_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CLI_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define CLI_HAS_SSE2 0
+#endif
+
+#if !defined(CLI_NO_SIMD) && (defined(__SSSE3__) || defined(__AVX__))
+#define CLI_HAS_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define CLI_HAS_SSSE3 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CLI_HAS_TSC 1
+#else
+#define CLI_HAS_TSC 0
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLI_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CLI_HAS_MMAP 0
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#define CLI_HAS_FIXED_STRING 1
+#else
+#define CLI_HAS_FIXED_STRING 0
+#endif
+
 namespace cli
 {
     class ParsingException : public std::exception
@@ -49,251 +148,4783 @@ namespace cli
             : mMessage(message)
         {}
 
-        const char* what() const throw() override
-        {
-            return mMessage.c_str();
+        const char* what() const throw() override
+        {
+            return mMessage.c_str();
+        }
+    private:
+        std::string mMessage;
+    };
+
+#if CLI_HAS_FIXED_STRING
+    template <size_t N>
+    struct FixedString
+    {
+        char mData[N];
+
+        constexpr FixedString(const char (&str)[N])
+        {
+            for (size_t i = 0; i < N; ++i)
+                mData[i] = str[i];
+        }
+
+        constexpr bool valid() const
+        {
+            if (N < 2)
+                return false;
+            for (size_t i = 0; i + 1 < N; ++i)
+                if (mData[i] == ' ' || mData[i] == '\0')
+                    return false;
+            return true;
+        }
+    };
+#endif
+
+    struct RegisteredOption
+    {
+        enum Kind
+        {
+            KIND_BOOL,
+            KIND_INT,
+            KIND_DOUBLE,
+            KIND_STRING,
+        };
+
+        const char* mName;
+        const char* mDescription;
+        Kind mKind;
+        void* mStorage;
+    };
+
+    class Registry
+    {
+    public:
+        typedef const RegisteredOption* const* Iterator;
+
+        static Iterator begin();
+        static Iterator end();
+    };
+
+    class MappedFile
+    {
+    public:
+        MappedFile()
+            : mData(nullptr)
+            , mSize(0)
+            , mMapped(false)
+        {
+        }
+
+        explicit MappedFile(const std::string& path, bool writable = false)
+            : mData(nullptr)
+            , mSize(0)
+            , mMapped(false)
+        {
+            open(path, writable);
+        }
+
+        ~MappedFile()
+        {
+            close();
+        }
+
+        // Writable mappings are private copy-on-write views: changes never reach the file.
+        void open(const std::string& path, bool writable = false)
+        {
+            close();
+#if CLI_HAS_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw ParsingException("Unable to open file '" + path + "'");
+
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | (writable ? PROT_WRITE : 0), MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED)
+                {
+                    mData = static_cast<char*>(address);
+                    mSize = static_cast<size_t>(info.st_size);
+                    mMapped = true;
+                }
+            }
+            ::close(fd);
+
+            if (mMapped)
+                return;
+#endif
+            std::ifstream file(path.c_str(), std::ios::binary);
+            if (!file)
+                throw ParsingException("Unable to open file '" + path + "'");
+            mBuffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            mData = mBuffer.empty() ? nullptr : mBuffer.data();
+            mSize = mBuffer.size();
+        }
+
+        void close()
+        {
+#if CLI_HAS_MMAP
+            if (mMapped)
+                ::munmap(mData, mSize);
+#endif
+            mData = nullptr;
+            mSize = 0;
+            mMapped = false;
+            mBuffer.clear();
+        }
+
+        char* data() const
+        {
+            return mData;
+        }
+
+        size_t size() const
+        {
+            return mSize;
+        }
+
+    private:
+        char* mData;
+        size_t mSize;
+        bool mMapped;
+        std::vector<char> mBuffer;
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator = (const MappedFile&);
+    };
+
+    // Non-owning view of a value's bytes, which are not NUL terminated.
+    class ValueView
+    {
+    public:
+        ValueView(const char* data, size_t size)
+            : mData(data)
+            , mSize(size)
+        {
+        }
+
+        const char* data() const
+        {
+            return mData;
+        }
+
+        size_t size() const
+        {
+            return mSize;
+        }
+
+        std::string str() const
+        {
+            return std::string(mData, mSize);
+        }
+
+    private:
+        const char* mData;
+        size_t mSize;
+    };
+
+    // Fixed-size binary form of a typed argument value. Addresses are in
+    // network byte order, IPv4 in the first four bytes of mData and IPv6 in
+    // all sixteen; UUIDs fill mData in RFC 4122 byte order and MAC addresses
+    // the first six bytes. Timestamps are UTC seconds since the Unix epoch.
+    struct TypedValue
+    {
+        unsigned char mData[16];
+        uint8_t mFamily;
+        uint8_t mPrefix;
+        uint16_t mPort;
+        uint32_t mNanoseconds;
+        int64_t mSeconds;
+    };
+
+    class ResponseFile
+    {
+    public:
+        ResponseFile()
+        {
+        }
+
+        explicit ResponseFile(const std::string& path)
+        {
+            map(path);
+            split();
+        }
+
+        // map() and split() are separate steps so callers can look at size()
+        // before paying for tokenization.
+        void map(const std::string& path)
+        {
+            mFile.open(path, true);
+            mTokens.clear();
+            mTail.clear();
+        }
+
+        int count() const
+        {
+            return static_cast<int>(mTokens.size());
+        }
+
+        char** tokens()
+        {
+            return mTokens.data();
+        }
+
+        size_t size() const
+        {
+            return mFile.size();
+        }
+
+        // Speculative parallel tokenization: every chunk is lexed assuming it starts
+        // between tokens, then a sequential pass re-lexes the (rare) chunks whose
+        // real starting state differs, and finally tokens are unescaped and NUL
+        // terminated in place, again in parallel.
+        void split()
+        {
+            const char* data = mFile.data();
+            size_t size = mFile.size();
+
+            size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), std::max<size_t>(1, size / CLI_RESPONSE_FILE_CHUNK));
+            std::vector<Chunk> chunks(workers);
+            for (size_t i = 0; i < workers; ++i)
+            {
+                size_t begin = i == 0 ? 0 : chunks[i - 1].mEnd;
+                size_t end = i + 1 == workers ? size : std::max(begin, size / workers * (i + 1));
+                while (end < size && data[end - 1] != '\n')
+                    ++end;
+                chunks[i].mBegin = begin;
+                chunks[i].mEnd = end;
+            }
+
+            const LexState initial = { MODE_BETWEEN, false, 0, false };
+            runParallel(workers, [&](size_t i) {
+                chunks[i].mEndState = initial;
+                lex(data, chunks[i].mBegin, chunks[i].mEnd, chunks[i].mEndState, chunks[i].mTokens);
+            });
+
+            std::vector<RawToken> tokens;
+            LexState state = initial;
+            for (auto& chunk : chunks)
+            {
+                if (state.mMode == MODE_BETWEEN && !state.mEscape)
+                {
+                    tokens.insert(tokens.end(), chunk.mTokens.begin(), chunk.mTokens.end());
+                    state = chunk.mEndState;
+                }
+                else
+                {
+                    lex(data, chunk.mBegin, chunk.mEnd, state, tokens);
+                }
+                std::vector<RawToken>().swap(chunk.mTokens);
+            }
+
+            if (state.mMode == MODE_DOUBLE_QUOTE || state.mMode == MODE_SINGLE_QUOTE)
+                throw ParsingException("Unterminated quote in response file");
+            if (state.mMode == MODE_WORD)
+            {
+                RawToken token = { state.mBegin, size, state.mCooked };
+                tokens.push_back(token);
+            }
+
+            mTokens.resize(tokens.size());
+            char* base = mFile.data();
+            size_t perWorker = (tokens.size() + workers - 1) / workers;
+            runParallel(workers, [&](size_t w) {
+                std::vector<char*> scratch;
+                for (size_t i = w * perWorker; i < std::min(tokens.size(), (w + 1) * perWorker); ++i)
+                {
+                    const RawToken& token = tokens[i];
+                    mTokens[i] = base + token.mBegin;
+                    if (token.mEnd == size)
+                        continue;
+                    if (token.mCooked)
+                    {
+                        scratch.clear();
+                        tokenize(base + token.mBegin, base + token.mEnd, scratch);
+                    }
+                    else
+                        base[token.mEnd] = '\0';
+                }
+            });
+
+            // A token running to the end of the file has no byte after it to
+            // hold its terminator, so it is finished in an owned copy.
+            if (!tokens.empty() && tokens.back().mEnd == size)
+            {
+                const RawToken& token = tokens.back();
+                mTail.assign(base + token.mBegin, size - token.mBegin);
+                mTail.push_back('\0');
+                if (token.mCooked)
+                {
+                    std::vector<char*> scratch;
+                    tokenize(&mTail[0], &mTail[0] + (size - token.mBegin), scratch);
+                }
+                mTokens.back() = &mTail[0];
+            }
+        }
+
+        // Splits [begin, end) into whitespace separated tokens, handling quotes and
+        // backslash escapes in place. Each token is NUL terminated, so *end must be
+        // writable. Returns false on an unterminated quote.
+        static bool tokenize(char* begin, char* end, std::vector<char*>& tokens)
+        {
+            char* write = begin;
+            char* read = begin;
+
+            while (read < end)
+            {
+                while (read < end && isSpace(*read))
+                    ++read;
+                if (read >= end)
+                    break;
+
+                char* token = write;
+                char quote = 0;
+                while (read < end)
+                {
+                    char c = *read;
+                    if (quote == 0 && isSpace(c))
+                        break;
+
+                    ++read;
+                    if (c == '\\' && read < end && quote != '\'')
+                        *write++ = *read++;
+                    else if (quote == 0 && (c == '"' || c == '\''))
+                        quote = c;
+                    else if (c == quote)
+                        quote = 0;
+                    else
+                        *write++ = c;
+                }
+
+                if (quote != 0)
+                    return false;
+
+                if (read < end)
+                    ++read;
+                *write++ = '\0';
+                tokens.push_back(token);
+            }
+
+            return true;
+        }
+
+    private:
+        enum Mode
+        {
+            MODE_BETWEEN,
+            MODE_WORD,
+            MODE_DOUBLE_QUOTE,
+            MODE_SINGLE_QUOTE,
+        };
+
+        struct LexState
+        {
+            Mode mMode;
+            bool mEscape;
+            size_t mBegin;
+            bool mCooked;
+        };
+
+        struct RawToken
+        {
+            size_t mBegin;
+            size_t mEnd;
+            bool mCooked;
+        };
+
+        struct Chunk
+        {
+            size_t mBegin;
+            size_t mEnd;
+            LexState mEndState;
+            std::vector<RawToken> mTokens;
+        };
+
+        MappedFile mFile;
+        std::vector<char*> mTokens;
+        std::string mTail;
+
+        static bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // Only records token boundaries, so a chunk lexed from a wrong starting
+        // state can simply be lexed again; nothing is written to the file yet.
+        static void lex(const char* data, size_t begin, size_t end, LexState& state, std::vector<RawToken>& tokens)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                char c = data[i];
+                if (state.mEscape)
+                {
+                    state.mEscape = false;
+                    continue;
+                }
+
+                switch (state.mMode)
+                {
+                case MODE_BETWEEN:
+                    if (isSpace(c))
+                        break;
+                    state.mMode = MODE_WORD;
+                    state.mBegin = i;
+                    state.mCooked = false;
+                    // fall through
+                case MODE_WORD:
+                    if (isSpace(c))
+                    {
+                        RawToken token = { state.mBegin, i, state.mCooked };
+                        tokens.push_back(token);
+                        state.mMode = MODE_BETWEEN;
+                    }
+                    else if (c == '\\')
+                        state.mEscape = state.mCooked = true;
+                    else if (c == '"')
+                        state.mMode = MODE_DOUBLE_QUOTE, state.mCooked = true;
+                    else if (c == '\'')
+                        state.mMode = MODE_SINGLE_QUOTE, state.mCooked = true;
+                    break;
+                case MODE_DOUBLE_QUOTE:
+                    if (c == '\\')
+                        state.mEscape = true;
+                    else if (c == '"')
+                        state.mMode = MODE_WORD;
+                    break;
+                case MODE_SINGLE_QUOTE:
+                    if (c == '\'')
+                        state.mMode = MODE_WORD;
+                    break;
+                }
+            }
+        }
+
+        template <typename Task>
+        static void runParallel(size_t workers, Task task)
+        {
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < workers; ++i)
+                threads.emplace_back(task, i);
+            task(0);
+            for (auto& thread : threads)
+                thread.join();
+        }
+    };
+
+    // Heap buffer aligned to CLI_BYTES_ALIGNMENT holding a decoded binary value.
+    // The allocation has 16 bytes of slack so decoders can store whole vectors.
+    class AlignedBuffer
+    {
+    public:
+        AlignedBuffer()
+            : mRaw(nullptr)
+            , mData(nullptr)
+            , mSize(0)
+        {
+        }
+
+        AlignedBuffer(const AlignedBuffer& other)
+            : AlignedBuffer()
+        {
+            if (other.mData != nullptr)
+                std::memcpy(allocate(other.mSize), other.mData, other.mSize);
+        }
+
+        AlignedBuffer(AlignedBuffer&& other) noexcept
+            : mRaw(other.mRaw)
+            , mData(other.mData)
+            , mSize(other.mSize)
+        {
+            other.mRaw = nullptr;
+            other.mData = nullptr;
+            other.mSize = 0;
+        }
+
+        AlignedBuffer& operator = (AlignedBuffer other)
+        {
+            std::swap(mRaw, other.mRaw);
+            std::swap(mData, other.mData);
+            std::swap(mSize, other.mSize);
+            return *this;
+        }
+
+        ~AlignedBuffer()
+        {
+            std::free(mRaw);
+        }
+
+        // Discards the contents and returns storage for size bytes.
+        unsigned char* allocate(size_t size)
+        {
+            clear();
+            mRaw = std::malloc(size + 16 + CLI_BYTES_ALIGNMENT - 1);
+            if (mRaw == nullptr)
+                throw std::bad_alloc();
+
+            uintptr_t address = reinterpret_cast<uintptr_t>(mRaw);
+            mData = reinterpret_cast<unsigned char*>((address + CLI_BYTES_ALIGNMENT - 1) & ~static_cast<uintptr_t>(CLI_BYTES_ALIGNMENT - 1));
+            mSize = size;
+            return mData;
+        }
+
+        void truncate(size_t size)
+        {
+            if (size < mSize)
+                mSize = size;
+        }
+
+        void clear()
+        {
+            std::free(mRaw);
+            mRaw = nullptr;
+            mData = nullptr;
+            mSize = 0;
+        }
+
+        const unsigned char* data() const
+        {
+            return mData;
+        }
+
+        size_t size() const
+        {
+            return mSize;
+        }
+
+    private:
+        void* mRaw;
+        unsigned char* mData;
+        size_t mSize;
+    };
+
+    // Seeded 64-bit hashing of byte strings, with a random per-process seed.
+    class KeyHash
+    {
+    public:
+        static uint64_t mix(uint64_t value)
+        {
+            value ^= value >> 32;
+            value *= 0xD6E8FEB86659FD93ull;
+            value ^= value >> 32;
+            value *= 0xD6E8FEB86659FD93ull;
+            value ^= value >> 32;
+            return value;
+        }
+
+        static uint64_t processSeed()
+        {
+            static const uint64_t seed = mix((static_cast<uint64_t>(std::random_device()()) << 32)
+                ^ std::random_device()()
+                ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+                ^ reinterpret_cast<uintptr_t>(&mix));
+            return seed;
+        }
+
+        // A seed of its own for each table that holds untrusted keys, derived
+        // from the process seed so one table's layout says nothing of another.
+        static uint64_t tableSeed()
+        {
+            static std::atomic<uint64_t> counter(0);
+            uint64_t count = ++counter;
+            return hash(reinterpret_cast<const char*>(&count), sizeof(count), processSeed());
+        }
+
+        // SipHash-1-3, keyed by the seed, so equal hashes for different keys
+        // cannot be predicted without it, whatever the key length.
+        static uint64_t hash(const char* key, size_t length, uint64_t seed)
+        {
+            uint64_t v0 = seed ^ 0x736F6D6570736575ull;
+            uint64_t v1 = mix(seed) ^ 0x646F72616E646F6Dull;
+            uint64_t v2 = seed ^ 0x6C7967656E657261ull;
+            uint64_t v3 = mix(seed) ^ 0x7465646279746573ull;
+            size_t i = 0;
+            for (; i + 8 <= length; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, key + i, 8);
+                v3 ^= word;
+                round(v0, v1, v2, v3);
+                v0 ^= word;
+            }
+
+            uint64_t last = static_cast<uint64_t>(length) << 56;
+            for (size_t k = 0; i + k < length; ++k)
+                last |= static_cast<uint64_t>(static_cast<unsigned char>(key[i + k])) << (8 * k);
+            v3 ^= last;
+            round(v0, v1, v2, v3);
+            v0 ^= last;
+
+            v2 ^= 0xFF;
+            round(v0, v1, v2, v3);
+            round(v0, v1, v2, v3);
+            round(v0, v1, v2, v3);
+            return v0 ^ v1 ^ v2 ^ v3;
+        }
+
+    private:
+        static uint64_t rotate(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        static void round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3)
+        {
+            v0 += v1;
+            v1 = rotate(v1, 13) ^ v0;
+            v0 = rotate(v0, 32);
+            v2 += v3;
+            v3 = rotate(v3, 16) ^ v2;
+            v0 += v3;
+            v3 = rotate(v3, 21) ^ v0;
+            v2 += v1;
+            v1 = rotate(v1, 17) ^ v2;
+            v2 = rotate(v2, 32);
+        }
+    };
+
+    // Open addressing table keyed by option names. Keys are hashed with a
+    // per-process random seed, and the table is reseeded (or grown) whenever an
+    // insert would need more than CLI_INDEX_MAX_PROBE probes. Only the schema
+    // inserts keys, so a lookup with untrusted input costs at most that many
+    // probes, and keys longer than any inserted one are rejected unhashed.
+    template <typename Value>
+    class HashIndex
+    {
+    public:
+        HashIndex()
+            : mSeed(KeyHash::processSeed())
+            , mMaxProbe(0)
+            , mMaxLength(0)
+        {
+        }
+
+        void insert(const std::string& key, Value value)
+        {
+            Value* existing = slotFor(key.data(), key.size());
+            if (existing != nullptr)
+            {
+                *existing = value;
+                return;
+            }
+
+            Entry entry = { key, value, KeyHash::hash(key.data(), key.size(), mSeed) };
+            mEntries.push_back(entry);
+            mMaxLength = std::max(mMaxLength, key.size());
+            if (mEntries.size() * 2 > mSlots.size() || !place(mEntries.size() - 1))
+                rebuild();
+        }
+
+        Value find(const char* key, size_t length) const
+        {
+            const Value* slot = const_cast<HashIndex*>(this)->slotFor(key, length);
+            return slot != nullptr ? *slot : Value();
+        }
+
+        Value find(const std::string& key) const
+        {
+            return find(key.data(), key.size());
+        }
+
+        void swap(HashIndex& other)
+        {
+            std::swap(mSeed, other.mSeed);
+            std::swap(mMaxProbe, other.mMaxProbe);
+            std::swap(mMaxLength, other.mMaxLength);
+            mEntries.swap(other.mEntries);
+            mSlots.swap(other.mSlots);
+        }
+
+        size_t size() const
+        {
+            return mEntries.size();
+        }
+
+    private:
+        struct Entry
+        {
+            std::string mKey;
+            Value mValue;
+            uint64_t mHash;
+        };
+
+        uint64_t mSeed;
+        size_t mMaxProbe;
+        size_t mMaxLength;
+        std::vector<Entry> mEntries;
+        std::vector<uint32_t> mSlots;
+
+        Value* slotFor(const char* key, size_t length)
+        {
+            if (length > mMaxLength || mSlots.empty())
+                return nullptr;
+
+            uint64_t hash = KeyHash::hash(key, length, mSeed);
+            size_t mask = mSlots.size() - 1;
+            for (size_t probe = 0; probe <= mMaxProbe; ++probe)
+            {
+                uint32_t slot = mSlots[(hash + probe) & mask];
+                if (slot == 0)
+                    return nullptr;
+
+                Entry& entry = mEntries[slot - 1];
+                if (entry.mHash == hash && entry.mKey.size() == length && std::memcmp(entry.mKey.data(), key, length) == 0)
+                    return &entry.mValue;
+            }
+            return nullptr;
+        }
+
+        bool place(size_t index)
+        {
+            size_t mask = mSlots.size() - 1;
+            for (size_t probe = 0; probe <= CLI_INDEX_MAX_PROBE; ++probe)
+            {
+                uint32_t& slot = mSlots[(mEntries[index].mHash + probe) & mask];
+                if (slot == 0)
+                {
+                    slot = static_cast<uint32_t>(index + 1);
+                    mMaxProbe = std::max(mMaxProbe, probe);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void rebuild()
+        {
+            size_t size = 16;
+            while (size < mEntries.size() * 2)
+                size *= 2;
+
+            for (unsigned attempt = 0; ; ++attempt)
+            {
+                if (attempt > 0)
+                    mSeed = KeyHash::mix(mSeed + 0x9E3779B97F4A7C15ull);
+                if (attempt > 0 && attempt % 4 == 0)
+                    size *= 2;
+
+                mSlots.assign(size, 0);
+                mMaxProbe = 0;
+                bool placed = true;
+                for (size_t i = 0; placed && i < mEntries.size(); ++i)
+                {
+                    mEntries[i].mHash = KeyHash::hash(mEntries[i].mKey.data(), mEntries[i].mKey.size(), mSeed);
+                    placed = place(i);
+                }
+                if (placed)
+                    return;
+            }
+        }
+    };
+
+    // Open addressing table of dense ids whose keys are stored by the owning
+    // container, which passes itself as keys (with data(id) and size(id)).
+    // Unlike HashIndex it takes untrusted keys: each table has its own random
+    // seed and, like HashIndex, is reseeded (or grown) whenever an insert
+    // would need more than CLI_INDEX_MAX_PROBE probes.
+    class IdTable
+    {
+    public:
+        static const uint32_t npos = 0xFFFFFFFFu;
+
+        IdTable()
+            : mSeed(KeyHash::tableSeed())
+            , mMaxProbe(0)
+        {
+        }
+
+        uint64_t hash(const char* key, size_t length) const
+        {
+            return KeyHash::hash(key, length, mSeed);
+        }
+
+        // The id of key, whose hash came from hash(), or npos.
+        template <typename Keys>
+        uint32_t find(uint64_t hash, const char* key, size_t length, const Keys& keys) const
+        {
+            if (mSlots.empty())
+                return npos;
+
+            size_t mask = mSlots.size() - 1;
+            for (size_t probe = 0; probe <= mMaxProbe; ++probe)
+            {
+                uint32_t slot = mSlots[(hash + probe) & mask];
+                if (slot == 0)
+                    return npos;
+                if (mHashes[slot - 1] == hash && keys.size(slot - 1) == length && std::memcmp(keys.data(slot - 1), key, length) == 0)
+                    return slot - 1;
+            }
+            return npos;
+        }
+
+        // Adds the next id; keys must already hold its key, whose hash came
+        // from hash().
+        template <typename Keys>
+        void insert(uint64_t hash, const Keys& keys)
+        {
+            mHashes.push_back(hash);
+            if (mHashes.size() * 2 > mSlots.size() || !place(mHashes.size() - 1))
+                rebuild(keys);
+        }
+
+        size_t size() const
+        {
+            return mHashes.size();
+        }
+
+    private:
+        uint64_t mSeed;
+        size_t mMaxProbe;
+        std::vector<uint64_t> mHashes;
+        std::vector<uint32_t> mSlots;
+
+        bool place(size_t id)
+        {
+            size_t mask = mSlots.size() - 1;
+            for (size_t probe = 0; probe <= CLI_INDEX_MAX_PROBE; ++probe)
+            {
+                uint32_t& slot = mSlots[(mHashes[id] + probe) & mask];
+                if (slot == 0)
+                {
+                    slot = static_cast<uint32_t>(id + 1);
+                    mMaxProbe = std::max(mMaxProbe, probe);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <typename Keys>
+        void rebuild(const Keys& keys)
+        {
+            size_t size = 16;
+            while (size < mHashes.size() * 2)
+                size *= 2;
+
+            for (unsigned attempt = 0; ; ++attempt)
+            {
+                if (attempt > 0)
+                    mSeed = KeyHash::mix(mSeed + 0x9E3779B97F4A7C15ull);
+                if (attempt > 0 && attempt % 4 == 0)
+                    size *= 2;
+
+                mSlots.assign(size, 0);
+                mMaxProbe = 0;
+                bool placed = true;
+                for (size_t i = 0; placed && i < mHashes.size(); ++i)
+                {
+                    if (attempt > 0)
+                        mHashes[i] = KeyHash::hash(keys.data(static_cast<uint32_t>(i)), keys.size(static_cast<uint32_t>(i)), mSeed);
+                    placed = place(i);
+                }
+                if (placed)
+                    return;
+            }
+        }
+    };
+
+    // Stores each distinct value once, in chunked storage that never moves,
+    // and hands out dense 32-bit ids. Equal values get equal ids, so values
+    // interned by a batch of parses compare as integers. Values are found
+    // through an IdTable, so untrusted values cannot degrade interning into
+    // long probe chains. Not thread safe.
+    class InternPool
+    {
+    public:
+        static const uint32_t npos = 0xFFFFFFFFu;
+
+        InternPool()
+            : mBlockUsed(0)
+            , mBytes(0)
+        {
+        }
+
+        InternPool(const InternPool&) = delete;
+        InternPool& operator = (const InternPool&) = delete;
+
+        uint32_t intern(const char* data, size_t length)
+        {
+            uint64_t hash = mTable.hash(data, length);
+            uint32_t id = mTable.find(hash, data, length, *this);
+            if (id != npos)
+                return id;
+
+            char* copy = store(length);
+            std::memcpy(copy, data, length);
+            Entry entry = { copy, length };
+            mEntries.push_back(entry);
+            mTable.insert(hash, *this);
+            return static_cast<uint32_t>(mEntries.size() - 1);
+        }
+
+        uint32_t intern(const std::string& value)
+        {
+            return intern(value.data(), value.size());
+        }
+
+        const char* data(uint32_t id) const
+        {
+            return mEntries.at(id).mData;
+        }
+
+        size_t size(uint32_t id) const
+        {
+            return mEntries.at(id).mLength;
+        }
+
+        std::string str(uint32_t id) const
+        {
+            return std::string(data(id), size(id));
+        }
+
+        // Number of distinct values and the bytes holding them.
+        size_t count() const
+        {
+            return mEntries.size();
+        }
+
+        size_t bytes() const
+        {
+            return mBytes;
+        }
+
+    private:
+        static const size_t BLOCK_SIZE = 1 << 16;
+
+        struct Entry
+        {
+            const char* mData;
+            size_t mLength;
+        };
+
+        std::vector<Entry> mEntries;
+        IdTable mTable;
+        std::vector<std::unique_ptr<char[]>> mBlocks;
+        std::vector<std::unique_ptr<char[]>> mLarge;
+        size_t mBlockUsed;
+        size_t mBytes;
+
+        // Large values get a block of their own so blocks stay densely used.
+        char* store(size_t length)
+        {
+            mBytes += length;
+            if (length > BLOCK_SIZE / 4)
+            {
+                mLarge.push_back(std::unique_ptr<char[]>(new char[length]));
+                return mLarge.back().get();
+            }
+
+            if (mBlocks.empty() || mBlockUsed + length > BLOCK_SIZE)
+            {
+                mBlocks.push_back(std::unique_ptr<char[]>(new char[BLOCK_SIZE]));
+                mBlockUsed = 0;
+            }
+
+            char* result = mBlocks.back().get() + mBlockUsed;
+            mBlockUsed += length;
+            return result;
+        }
+    };
+
+    // Fixed ring of recent parse events for post-mortem analysis. Each event is
+    // two 64-bit words claimed with one atomic increment and written with
+    // relaxed stores, so recording is lock free and never allocates. The
+    // whole ring is a single block starting with a magic word, which makes
+    // it easy to find in a core file and to dump from a signal handler.
+    class FlightRecorder
+    {
+    public:
+        enum EventKind
+        {
+            EVENT_PARSE_BEGIN,
+            EVENT_PARSE_END,
+            EVENT_OPTION,
+            EVENT_VALUE,
+            EVENT_UNKNOWN,
+            EVENT_PASSTHROUGH,
+            EVENT_HELP,
+            EVENT_RESPONSE_FILE,
+        };
+
+        struct Event
+        {
+            uint64_t mTimestamp;
+            uint32_t mToken;
+            uint16_t mOption;
+            uint8_t mKind;
+            uint8_t mDepth;
+        };
+
+        static const uint64_t MAGIC = 0x3152544C46494C43ull;
+
+        // Rounds capacity up to a power of two.
+        explicit FlightRecorder(size_t capacity = 4096)
+            : mCapacity(1)
+        {
+            while (mCapacity < capacity)
+                mCapacity *= 2;
+
+            mWords.reset(new std::atomic<uint64_t>[HEADER_WORDS + 2 * mCapacity]);
+            for (size_t i = 0; i < HEADER_WORDS + 2 * mCapacity; ++i)
+                mWords[i].store(0, std::memory_order_relaxed);
+            mWords[0].store(MAGIC, std::memory_order_relaxed);
+            mWords[1].store(mCapacity | (static_cast<uint64_t>(CLI_HAS_TSC) << 63), std::memory_order_relaxed);
+        }
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator = (const FlightRecorder&) = delete;
+
+        void record(EventKind kind, size_t token, size_t option, int depth)
+        {
+            uint64_t slot = mWords[2].fetch_add(1, std::memory_order_relaxed) & (mCapacity - 1);
+            uint64_t packed = static_cast<uint32_t>(token)
+                | (static_cast<uint64_t>(static_cast<uint16_t>(option)) << 32)
+                | (static_cast<uint64_t>(kind) << 48)
+                | (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 56);
+            mWords[HEADER_WORDS + 2 * slot].store(timestamp(), std::memory_order_relaxed);
+            mWords[HEADER_WORDS + 2 * slot + 1].store(packed, std::memory_order_release);
+        }
+
+        // Copies up to max of the most recent events, oldest first.
+        size_t snapshot(Event* events, size_t max) const
+        {
+            uint64_t head = mWords[2].load(std::memory_order_acquire);
+            size_t count = static_cast<size_t>(std::min<uint64_t>(std::min<uint64_t>(head, mCapacity), max));
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t slot = (head - count + i) & (mCapacity - 1);
+                uint64_t packed = mWords[HEADER_WORDS + 2 * slot + 1].load(std::memory_order_acquire);
+                events[i].mTimestamp = mWords[HEADER_WORDS + 2 * slot].load(std::memory_order_relaxed);
+                events[i].mToken = static_cast<uint32_t>(packed);
+                events[i].mOption = static_cast<uint16_t>(packed >> 32);
+                events[i].mKind = static_cast<uint8_t>(packed >> 48);
+                events[i].mDepth = static_cast<uint8_t>(packed >> 56);
+            }
+            return count;
+        }
+
+        size_t capacity() const
+        {
+            return mCapacity;
+        }
+
+        // Total events recorded, including those already overwritten.
+        uint64_t recorded() const
+        {
+            return mWords[2].load(std::memory_order_relaxed);
+        }
+
+#if CLI_HAS_MMAP
+        // Writes the raw ring (magic, capacity and TSC flag, head, then the
+        // events) to fd using only write(2), so it is safe in a signal handler.
+        bool dump(int fd) const
+        {
+            const char* data = reinterpret_cast<const char*>(mWords.get());
+            size_t left = (HEADER_WORDS + 2 * mCapacity) * sizeof(uint64_t);
+            while (left > 0)
+            {
+                ssize_t written = ::write(fd, data, left);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+                data += written;
+                left -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+#endif
+
+        // Cycle counter where available, steady clock nanoseconds otherwise.
+        static uint64_t timestamp()
+        {
+#if CLI_HAS_TSC && defined(_MSC_VER)
+            return __rdtsc();
+#elif CLI_HAS_TSC
+            return __builtin_ia32_rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+    private:
+        static const size_t HEADER_WORDS = 3;
+
+        size_t mCapacity;
+        std::unique_ptr<std::atomic<uint64_t>[]> mWords;
+
+        static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Events must be dumpable as plain words");
+    };
+
+    class FrozenOptions;
+    class ColumnCollector;
+
+    class Parser
+    {
+    public:
+        enum ParsingResult
+        {
+            PARSED_OK = 0,
+            PARSED_HELP = 1,
+            PARSED_FAILED = -2,
+            PARSED_FAILED_VALIDATOR = -3,
+            PARSED_FAILED_LIMIT = -4,
+        };
+
+        enum Limit
+        {
+            LIMIT_NONE,
+            LIMIT_TOKENS,
+            LIMIT_TOTAL_BYTES,
+            LIMIT_VALUE_LENGTH,
+            LIMIT_RESPONSE_FILE_DEPTH,
+            LIMIT_RESPONSE_FILE_SIZE,
+            LIMIT_TIME,
+        };
+
+        struct Limits
+        {
+            size_t mMaxTokens;
+            size_t mMaxTotalBytes;
+            size_t mMaxValueLength;
+            size_t mMaxResponseFileDepth;
+            size_t mMaxResponseFileSize;
+            std::chrono::nanoseconds mTimeBudget;
+        };
+
+        // Encoding checks applied to an argument value before the option validator.
+        enum ValueCheck
+        {
+            CHECK_NONE = 0,
+            CHECK_UTF8 = 1 << 0,
+            CHECK_NO_CONTROL = 1 << 1,
+            DECODE_HEX = 1 << 2,
+            DECODE_BASE64 = 1 << 3,
+            // "@path" stands for the contents of path, "@@" for a literal "@".
+            FILE_REFERENCE = 1 << 4,
+            // The value is always the path of the file holding the contents.
+            FILE_PATH = 1 << 5,
+            // Typed values, parsed once into Option::typed(). TYPE_IPV4 | TYPE_IPV6
+            // accepts either family; TYPE_CIDR accepts both.
+            TYPE_IPV4 = 1 << 6,
+            TYPE_IPV6 = 1 << 7,
+            TYPE_CIDR = 1 << 8,
+            TYPE_PORT = 1 << 9,
+            TYPE_UUID = 1 << 10,
+            TYPE_TIMESTAMP = 1 << 11,
+            TYPE_MAC = 1 << 12,
+            TYPE_MASK = TYPE_IPV4 | TYPE_IPV6 | TYPE_CIDR | TYPE_PORT | TYPE_UUID | TYPE_TIMESTAMP | TYPE_MAC,
+        };
+
+        // Where an option was provided from, as recorded in audit records.
+        enum Source
+        {
+            SOURCE_NONE,
+            SOURCE_COMMAND_LINE,
+            SOURCE_RESPONSE_FILE,
+            SOURCE_QUERY,
+            SOURCE_ENCODED,
+        };
+
+        enum RecordFormat
+        {
+            RECORD_JSON_LINE,
+            RECORD_BINARY,
+        };
+
+        class Option
+        {
+        public:
+
+            class Argument
+            {
+            public:
+                Argument(const std::string& id, const std::string& desc, unsigned checks = CHECK_NONE)
+                    : mId(id)
+                    , mDesc(desc)
+                    , mChecks(checks)
+                    , mChild(nullptr)
+                    , mExpandState(0)
+                    , mExpansion(0)
+                    , mInterned(InternPool::npos)
+                    , mTyped()
+                {}
+
+                // The value is a command line parsed by child, which must outlive
+                // the parent parser.
+                Argument(const std::string& id, const std::string& desc, Parser& child)
+                    : mId(id)
+                    , mDesc(desc)
+                    , mChecks(CHECK_NONE)
+                    , mChild(&child)
+                    , mExpandState(0)
+                    , mExpansion(0)
+                    , mInterned(InternPool::npos)
+                    , mTyped()
+                {}
+
+            private:
+                std::string mId;
+                std::string mDesc;
+                unsigned mChecks;
+                std::string mValue;
+                AlignedBuffer mBytes;
+                Parser* mChild;
+                mutable int mExpandState;
+                mutable size_t mExpansion;
+                uint32_t mInterned;
+                TypedValue mTyped;
+                mutable std::shared_ptr<MappedFile> mFile;
+
+                friend class Parser;
+                friend class FrozenOptions;
+                friend class ColumnCollector;
+            };
+
+            Option(
+                const std::list<std::string>& opts,
+                const std::string& description = "",
+                bool mandatory = true, 
+                const std::vector<Argument>& args = {},
+                std::function<bool(Option&)> validator = nullptr
+            )
+                : mOpts(opts)
+                , mDescription(description)
+                , mMandatory(mandatory)
+                , mArgsRef(args)
+                , mProvided(false)
+                , mSource(SOURCE_NONE)
+                , mSecret(false)
+                , mIndex(0)
+                , mValidator(validator)
+                , mRegistered(nullptr)
+            {
+                for(size_t i = 0; i < mArgsRef.size(); ++i)
+                    mArgsMap.insert(std::make_pair(mArgsRef[i].mId, i));
+            }
+
+            const std::string& value(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end())
+                    throw ParsingException("Invalid Argument");
+                return mArgsRef[mArgsMap.at(id)].mValue;
+            }
+
+            // Decoded payload of an argument declared with DECODE_HEX or DECODE_BASE64.
+            const AlignedBuffer& bytes(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end())
+                    throw ParsingException("Invalid Argument");
+                return mArgsRef[mArgsMap.at(id)].mBytes;
+            }
+
+            // Binary value of an argument declared with one of the TYPE_* checks.
+            const TypedValue& typed(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end())
+                    throw ParsingException("Invalid Argument");
+                return mArgsRef[mArgsMap.at(id)].mTyped;
+            }
+
+            // Contents of an argument, read from its file on first access for
+            // FILE_REFERENCE and FILE_PATH arguments. The view stays valid until
+            // the next parse or reset().
+            ValueView content(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end())
+                    throw ParsingException("Invalid Argument");
+
+                const Argument& arg = mArgsRef[mArgsMap.at(id)];
+                const std::string& value = arg.mValue;
+                size_t skip = 0;
+                if (arg.mChecks & FILE_PATH)
+                    skip = std::string::npos;
+                else if ((arg.mChecks & FILE_REFERENCE) && !value.empty() && value[0] == '@')
+                    skip = value.size() > 1 && value[1] == '@' ? 1 : std::string::npos;
+
+                if (skip != std::string::npos)
+                    return ValueView(value.data() + skip, value.size() - skip);
+
+                if (!arg.mFile)
+                {
+                    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+                    file->open((arg.mChecks & FILE_PATH) ? value : value.substr(1));
+                    arg.mFile = file;
+                }
+                return ValueView(arg.mFile->data(), arg.mFile->size());
+            }
+
+            // Id of the value in the parser's intern pool, or InternPool::npos.
+            uint32_t internId(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end())
+                    throw ParsingException("Invalid Argument");
+                return mArgsRef[mArgsMap.at(id)].mInterned;
+            }
+
+            // Result of the child parser attached to an argument.
+            const Parser& child(const std::string& id) const
+            {
+                if (mArgsMap.find(id) == mArgsMap.end() || mArgsRef[mArgsMap.at(id)].mChild == nullptr)
+                    throw ParsingException("Invalid Argument");
+                return *mArgsRef[mArgsMap.at(id)].mChild;
+            }
+
+        private:
+            std::list<std::string> mOpts;
+            std::string mDescription;
+            bool mMandatory;
+            std::vector<Argument> mArgsRef;
+            std::map<std::string, size_t> mArgsMap;
+            bool mProvided;
+            Source mSource;
+            bool mSecret;
+            size_t mIndex;
+            std::function<bool(Option&)> mValidator;
+            const RegisteredOption* mRegistered;
+
+            friend class Parser;
+            friend class FrozenOptions;
+            friend class ColumnCollector;
+
+            bool checkMandatory()
+            {
+                return !mMandatory || mProvided;
+            }
+        };
+        
+        Parser(const std::string& program = "", const std::string& version = "", const std::string& description = "")
+            : mProgram(program)
+            , mVersion(version)
+            , mDescription(description)
+            , mOutput(&std::cout)
+            , mErrors(&std::cerr)
+            , mLimitExceeded(LIMIT_NONE)
+            , mResponseFiles(false)
+            , mParallelResolve(true)
+            , mExpanding(false)
+            , mInternPool(nullptr)
+            , mKept(nullptr)
+            , mRecorder(nullptr)
+            , mSchemaHash(0)
+            , mIndexState(INDEX_CURRENT)
+            , mDeferredIndexing(false)
+            , mScanWhilePending(false)
+        {
+            Limits limits = { 0, 0, 0, CLI_RESPONSE_FILE_DEPTH, 0, std::chrono::nanoseconds(0) };
+            mLimits = limits;
+        }
+
+        // A copy gets lookup tables of its own, built from its own options. A
+        // background build pending in the source only reads the source's
+        // options, so it keeps running.
+        Parser(const Parser& other)
+            : mProgram(other.mProgram)
+            , mVersion(other.mVersion)
+            , mDescription(other.mDescription)
+            , mOptionRefs(other.mOptionRefs)
+            , mOutput(other.mOutput)
+            , mErrors(other.mErrors)
+            , mLimits(other.mLimits)
+            , mLimitExceeded(other.mLimitExceeded)
+            , mResponseFiles(other.mResponseFiles)
+            , mParallelResolve(other.mParallelResolve)
+            , mDeprecatedAliases(other.mDeprecatedAliases)
+            , mExpansions(other.mExpansions)
+            , mExpanding(false)
+            , mInternPool(other.mInternPool)
+            , mKept(nullptr)
+            , mRecorder(other.mRecorder)
+            , mChildren(other.mChildren)
+            , mSchemaHash(other.mSchemaHash)
+            , mIndexState(INDEX_STALE)
+            , mDeferredIndexing(other.mDeferredIndexing)
+            , mScanWhilePending(other.mScanWhilePending)
+            , mHelp(other.mIndexState == INDEX_BUILDING ? std::string() : other.mHelp)
+        {
+            for (auto& opt : mOptionRefs)
+                mOptionsByIndex.push_back(&opt);
+            if (!mDeferredIndexing)
+                syncIndex(true);
+        }
+
+        // Moving keeps the option nodes, so the index and a pending background
+        // build, which only hold pointers to them, move along.
+        Parser(Parser&& other)
+            : Parser()
+        {
+            *this = std::move(other);
+        }
+
+        Parser& operator = (const Parser& other)
+        {
+            if (this != &other)
+                *this = Parser(other);
+            return *this;
+        }
+
+        Parser& operator = (Parser&& other)
+        {
+            if (this == &other)
+                return *this;
+
+            // A pending build of this parser reads the options replaced below.
+            if (mIndexing.valid())
+                mIndexing.wait();
+
+            mProgram = std::move(other.mProgram);
+            mVersion = std::move(other.mVersion);
+            mDescription = std::move(other.mDescription);
+            mOptionRefs = std::move(other.mOptionRefs);
+            mOptionsMap = std::move(other.mOptionsMap);
+            mOutput = other.mOutput;
+            mErrors = other.mErrors;
+            mLimits = other.mLimits;
+            mLimitExceeded = other.mLimitExceeded;
+            mResponseFiles = other.mResponseFiles;
+            mParallelResolve = other.mParallelResolve;
+            mDeprecatedAliases = std::move(other.mDeprecatedAliases);
+            mExpansions = std::move(other.mExpansions);
+            mExpanding = false;
+            mInternPool = other.mInternPool;
+            mKept = nullptr;
+            mRecorder = other.mRecorder;
+            mOptionsByIndex = std::move(other.mOptionsByIndex);
+            mChildren = std::move(other.mChildren);
+            mSchemaHash = other.mSchemaHash;
+            mIndexState = other.mIndexState;
+            mDeferredIndexing = other.mDeferredIndexing;
+            mScanWhilePending = other.mScanWhilePending;
+            mHelp = std::move(other.mHelp);
+            mIndexing = std::move(other.mIndexing);
+#if CLI_HAS_FIXED_STRING
+            mAccessCache.clear();
+#endif
+
+            other.mOptionRefs.clear();
+            other.mOptionsByIndex.clear();
+            other.mChildren.clear();
+            other.mSchemaHash = 0;
+            other.mIndexState = INDEX_STALE;
+#if CLI_HAS_FIXED_STRING
+            // The moved-from cache points at options that now belong to this parser.
+            other.mAccessCache.clear();
+#endif
+            return *this;
+        }
+
+        void addOptions(const std::list<Option>& options)
+        {
+            for (auto option : options)
+                addOption(option);
+        }
+
+        void addOption(Option& option)
+        {
+            syncIndex(true);
+            mOptionRefs.push_back(option);
+            Option& ref = mOptionRefs.back();
+            ref.mIndex = mOptionRefs.size() - 1;
+            mOptionsByIndex.push_back(&ref);
+            mSchemaHash = hashOption(mSchemaHash, ref);
+            for (const auto& arg : ref.mArgsRef)
+            {
+                if (arg.mChild != nullptr)
+                    mChildren.push_back(arg.mChild);
+            }
+            mHelp.clear();
+            if (mDeferredIndexing)
+                mIndexState = INDEX_STALE;
+            if (mIndexState == INDEX_CURRENT)
+            {
+                for (auto opt : ref.mOpts)
+                    mOptionsMap.insert(opt, &ref);
+            }
+#if CLI_HAS_FIXED_STRING
+            mAccessCache.clear();
+#endif
+        }
+
+        // Lets parse() read more options from the file named by an "@path" token.
+        // Off by default. Embedded command lines and decoded commands never
+        // expand response files.
+        void setResponseFiles(bool enabled)
+        {
+            mResponseFiles = enabled;
+        }
+
+        // Lets parse() look up the tokens of an argv longer than
+        // CLI_PARALLEL_PARSE_THRESHOLD on several threads before scanning it.
+        // On by default; the results are the same either way.
+        void setParallelResolve(bool enabled)
+        {
+            mParallelResolve = enabled;
+        }
+
+        // With deferred indexing, addOption only records the option and the lookup
+        // index is built once, at the first parse or by buildIndexAsync.
+        void setDeferredIndexing(bool deferred)
+        {
+            mDeferredIndexing = deferred;
+        }
+
+        // Builds the lookup index and the help text on a background thread while
+        // the application continues its startup. A parse waits for the build to
+        // finish, unless scanWhilePending is set, in which case parses arriving
+        // before it is ready scan the option list instead.
+        void buildIndexAsync(bool scanWhilePending = false)
+        {
+            syncIndex(true);
+            mScanWhilePending = scanWhilePending;
+            mIndexState = INDEX_BUILDING;
+            mIndexing = std::async(std::launch::async, &Parser::buildIndexWithHelp, mOptionsByIndex, mProgram, mVersion, mDescription);
+        }
+
+        bool indexReady() const
+        {
+            return mIndexState == INDEX_CURRENT || (mIndexState == INDEX_BUILDING && mIndexing.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        }
+
+        void addDeprecatedAlias(const std::string& alias, const std::string& target)
+        {
+            DeprecatedAlias entry = { target, false };
+            mDeprecatedAliases[alias] = entry;
+        }
+
+        void addRegisteredOptions()
+        {
+            for (Registry::Iterator it = Registry::begin(); it != Registry::end(); ++it)
+            {
+                const RegisteredOption* reg = *it;
+                if (reg == nullptr)
+                    continue;
+
+                std::vector<Option::Argument> args;
+                if (reg->mKind != RegisteredOption::KIND_BOOL)
+                    args.push_back(Option::Argument("value", "The option value."));
+
+                Option option({reg->mName}, reg->mDescription, false, args);
+                option.mRegistered = reg;
+                addOption(option);
+            }
+        }
+
+        void setStreams(std::ostream& output, std::ostream& errors)
+        {
+            mOutput = &output;
+            mErrors = &errors;
+        }
+
+        std::ostream& outputStream() const
+        {
+            return *mOutput;
+        }
+
+        std::ostream& errorStream() const
+        {
+            return *mErrors;
+        }
+
+        std::shared_ptr<const FrozenOptions> freeze() const;
+
+        // Interns every committed argument value into pool, which may be shared
+        // by the parsers of a batch and must outlive them. Pass nullptr to stop.
+        void setInternPool(InternPool* pool)
+        {
+            mInternPool = pool;
+        }
+
+        // Records parse events into recorder, which may be shared by several
+        // parsers and must outlive them. Pass nullptr to stop.
+        void setFlightRecorder(FlightRecorder* recorder)
+        {
+            mRecorder = recorder;
+        }
+
+        // Values of secret options are replaced by a marker in audit records.
+        void markSecret(const std::string& opt)
+        {
+            Option* found = findOption(opt);
+            if (found == nullptr)
+                throw ParsingException("Option Not Found!");
+            found->mSecret = true;
+        }
+
+        // Stable hash of the schema: per option, in order, its spellings,
+        // registered kind and argument ids and checks, then the fingerprints
+        // of attached child parsers. Every field is hashed under a fixed seed
+        // on its own, lengths and counts included, and folded into the running
+        // state, so different schemas collide only with negligible probability.
+        // The options' part is kept up to date by addOption(); children are
+        // folded in on each call, so options added to a child after it was
+        // attached are covered, and the call itself writes nothing.
+        uint64_t fingerprint() const
+        {
+            uint64_t hash = KeyHash::mix(mSchemaHash ^ KeyHash::mix(FINGERPRINT_SEED ^ mOptionRefs.size()));
+            for (auto child : mChildren)
+                hash = KeyHash::mix(hash ^ child->fingerprint());
+            return hash != 0 ? hash : 1;
+        }
+
+        // Encodes the provided options of the current parse result for a peer
+        // with the same schema: a "CLIB" header with the total length and the
+        // schema fingerprint, then per option its index, spelling and values,
+        // all length-prefixed little-endian. Returns the size needed, as
+        // serialize() does.
+        size_t encodeCommand(char* buffer, size_t capacity) const
+        {
+            RecordWriter writer(buffer, capacity);
+            uint32_t count = 0;
+            for (const auto& opt : mOptionRefs)
+                count += opt.mProvided ? 1 : 0;
+
+            uint64_t hash = fingerprint();
+            writer.put("CLIB", 4);
+            writer.putU32(0);
+            writer.putU32(static_cast<uint32_t>(hash));
+            writer.putU32(static_cast<uint32_t>(hash >> 32));
+            writer.putU32(count);
+            for (const auto& opt : mOptionRefs)
+            {
+                if (!opt.mProvided)
+                    continue;
+
+                writer.putU32(static_cast<uint32_t>(opt.mIndex));
+                writer.putString(opt.mOpts.front().data(), opt.mOpts.front().size());
+                writer.putU32(static_cast<uint32_t>(opt.mArgsRef.size()));
+                for (const auto& arg : opt.mArgsRef)
+                    writer.putString(arg.mValue.data(), arg.mValue.size());
+            }
+            writer.patchU32(4, static_cast<uint32_t>(writer.length()));
+            return writer.length();
+        }
+
+        // Decodes a command produced by encodeCommand. With a matching
+        // fingerprint the options are addressed by index, with no lookups;
+        // otherwise the spellings and values are parsed as a command line.
+        ParsingResult parseCommand(const char* data, size_t length)
+        {
+            syncIndex(!mScanWhilePending);
+            clearExpansions();
+            mLimitExceeded = LIMIT_NONE;
+            if (mLimits.mMaxTotalBytes > 0 && length > mLimits.mMaxTotalBytes)
+                return exceedLimit(LIMIT_TOTAL_BYTES);
+
+            RecordReader reader(data, length);
+            uint32_t total = 0;
+            uint32_t low = 0;
+            uint32_t high = 0;
+            uint32_t count = 0;
+            if (length < 4 || std::memcmp(data, "CLIB", 4) != 0 || !reader.skip(4) || !reader.getU32(total) || total != length
+                || !reader.getU32(low) || !reader.getU32(high) || !reader.getU32(count))
+                return invalidCommand();
+            if (mLimits.mMaxTokens > 0 && count > mLimits.mMaxTokens)
+                return exceedLimit(LIMIT_TOKENS);
+
+            bool direct = (static_cast<uint64_t>(high) << 32 | low) == fingerprint();
+            std::vector<char> text;
+            std::vector<size_t> offsets;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t index = 0;
+                uint32_t args = 0;
+                const char* name = nullptr;
+                uint32_t nameLength = 0;
+                if (!reader.getU32(index) || !reader.getString(name, nameLength) || !reader.getU32(args))
+                    return invalidCommand();
+
+                Option* opt = direct && index < mOptionsByIndex.size() ? mOptionsByIndex[index] : nullptr;
+                if (direct && (opt == nullptr || args != opt->mArgsRef.size()))
+                    return invalidCommand();
+                if (!direct)
+                    appendToken(text, offsets, name, nameLength);
+
+                for (uint32_t j = 0; j < args; ++j)
+                {
+                    const char* value = nullptr;
+                    uint32_t valueLength = 0;
+                    if (!reader.getString(value, valueLength))
+                        return invalidCommand();
+                    if (mLimits.mMaxValueLength > 0 && valueLength > mLimits.mMaxValueLength)
+                        return exceedLimit(LIMIT_VALUE_LENGTH);
+
+                    if (direct)
+                        opt->mArgsRef[j].mValue.assign(value, valueLength);
+                    else
+                        appendToken(text, offsets, value, valueLength);
+                }
+
+                if (direct)
+                {
+                    ParsingResult result = commitOption(*opt, SOURCE_ENCODED);
+                    if (result != PARSED_OK)
+                        return result;
+                }
+            }
+
+            if (!reader.done())
+                return invalidCommand();
+            if (direct)
+                return checkMandatories();
+
+            std::vector<char*> tokens;
+            for (size_t offset : offsets)
+                tokens.push_back(text.data() + offset);
+            return parseArgv(0, static_cast<int>(tokens.size()), tokens.data(), false);
+        }
+
+        // Writes the current parse result as one audit record into buffer,
+        // without allocating. Returns the record size; the record is complete
+        // only when that is not larger than capacity.
+        size_t serialize(char* buffer, size_t capacity, RecordFormat format = RECORD_JSON_LINE) const
+        {
+            static const char* const sources[] = { "none", "command_line", "response_file", "query", "encoded" };
+            RecordWriter writer(buffer, capacity);
+
+            if (format == RECORD_BINARY)
+            {
+                writer.put("CLIR", 4);
+                writer.putU32(0);
+                writer.putU32(static_cast<uint32_t>(mOptionRefs.size()));
+                for (const auto& opt : mOptionRefs)
+                {
+                    writer.putU8(static_cast<unsigned char>((opt.mProvided ? 1 : 0) | (opt.mSecret ? 2 : 0) | (opt.mSource << 4)));
+                    writer.putString(opt.mOpts.front().data(), opt.mOpts.front().size());
+                    writer.putU32(static_cast<uint32_t>(opt.mProvided ? opt.mArgsRef.size() : 0));
+                    for (size_t i = 0; opt.mProvided && i < opt.mArgsRef.size(); ++i)
+                    {
+                        const Option::Argument& arg = opt.mArgsRef[i];
+                        writer.putString(arg.mId.data(), arg.mId.size());
+                        writer.putString(arg.mValue.data(), opt.mSecret ? 0 : arg.mValue.size());
+                    }
+                }
+                writer.patchU32(4, static_cast<uint32_t>(writer.length()));
+                return writer.length();
+            }
+
+            writer.put("{\"program\":");
+            writer.putJson(mProgram.data(), mProgram.size());
+            writer.put(",\"options\":[");
+            bool first = true;
+            for (const auto& opt : mOptionRefs)
+            {
+                writer.put(first ? "{\"name\":" : ",{\"name\":");
+                first = false;
+                writer.putJson(opt.mOpts.front().data(), opt.mOpts.front().size());
+                if (!opt.mProvided)
+                {
+                    writer.put(",\"provided\":false}");
+                    continue;
+                }
+
+                writer.put(",\"provided\":true,\"source\":\"");
+                writer.put(sources[opt.mSource]);
+                writer.put("\",\"args\":{");
+                for (size_t i = 0; i < opt.mArgsRef.size(); ++i)
+                {
+                    const Option::Argument& arg = opt.mArgsRef[i];
+                    if (i > 0)
+                        writer.put(",");
+                    writer.putJson(arg.mId.data(), arg.mId.size());
+                    writer.put(":");
+                    if (opt.mSecret)
+                        writer.put("\"<redacted>\"");
+                    else
+                        writer.putJson(arg.mValue.data(), arg.mValue.size());
+                }
+                writer.put("}}");
+            }
+            writer.put("]}\n");
+            return writer.length();
+        }
+
+        void reset()
+        {
+            clearExpansions();
+            for (auto& opt : mOptionRefs)
+            {
+                opt.mProvided = false;
+                opt.mSource = SOURCE_NONE;
+                for (auto& arg : opt.mArgsRef)
+                {
+                    arg.mValue.clear();
+                    arg.mBytes.clear();
+                    arg.mInterned = InternPool::npos;
+                    arg.mTyped = TypedValue();
+                    arg.mFile.reset();
+                    if (arg.mChild != nullptr)
+                        arg.mChild->reset();
+                }
+            }
+        }
+
+        std::string composeHelpString() const
+        {
+            return composeHelp(mProgram, mVersion, mDescription, mOptionsByIndex);
+        }
+
+        static std::string composeHelp(const std::string& program, const std::string& version, const std::string& description, const std::vector<Option*>& options)
+        {
+            std::stringstream ss;
+            
+            if (program.length() > 0)
+            {
+                ss << separtor() << std::endl;
+                ss << std::left << std::setw(CLI_MAX_LINE_WIDTH * 75 / 100) << program;
+                ss << std::right << std::setw(CLI_MAX_LINE_WIDTH * 25 / 100) << version;
+                ss << std::endl << separtor() << std::endl;
+            }
+            
+            if(description.length() > 0)
+                ss << splitWords(description) << std::endl << separtor() << std::endl;
+
+            ss << std::endl;
+
+            for (const Option* option : options)
+            {
+                const Option& opt = *option;
+                std::string optsStr = ((opt.mMandatory) ? "*" : "") + opt.mOpts.front();
+                for (auto it = ++opt.mOpts.begin(); it != opt.mOpts.end(); ++it)
+                    optsStr += ", " + *it;
+
+                if (opt.mArgsRef.size() > 0)
+                    optsStr += " {args...}";
+
+                ss << std::left << std::setw(CLI_MAX_LINE_WIDTH * 30 / 100) << optsStr;
+                ss << std::left << splitWords(opt.mDescription, CLI_MAX_LINE_WIDTH * 70 / 100, std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' '));
+                ss << std::endl;
+
+                if (opt.mArgsRef.size() > 0)
+                {
+                    ss << std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' ') << "Arguments: " << std::endl;
+
+                    for (const auto& arg : opt.mArgsRef)
+                    {
+                        std::string argStr = "{" + arg.mId + "} => ";
+                        ss << std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' ') << argStr;
+                        ss << splitWords(arg.mDesc, CLI_MAX_LINE_WIDTH * 70 / 100, std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' '));
+                        ss << std::endl;
+                    }
+                }
+            }
+
+            return ss.str();
+        }
+
+        static std::string separtor()
+        {
+            return std::string(CLI_MAX_LINE_WIDTH, '-');
+        }
+
+        static std::string splitWords(const std::string& value, size_t width = CLI_MAX_LINE_WIDTH, const std::string& padStr = "")
+        {
+            std::stringstream ss;
+            std::string copy = value;
+            std::string padStrInUse;
+
+            while (copy.size() > width)
+            {
+                std::string block = copy.substr(0, width);
+                size_t index = block.find_last_of(' ');
+                
+                if (index != std::string::npos)
+                {
+                    ss << padStrInUse << block.substr(0, index) << std::endl;
+                    copy = copy.substr(index + 1);
+                }
+                else
+                {
+                    ss << padStrInUse << block << std::endl;
+                    copy = copy.substr(width);
+                }
+
+                padStrInUse = padStr;
+            }
+            
+            ss << padStrInUse << copy;
+            return ss.str();
+        }
+
+        const Limits& limits() const
+        {
+            return mLimits;
+        }
+
+        void setLimits(const Limits& limits)
+        {
+            mLimits = limits;
+        }
+
+        Limit limitExceeded() const
+        {
+            return mLimitExceeded;
+        }
+
+        ParsingResult parse(int argc, char* argv[])
+        {
+            return parseArgv(1, argc, argv, mResponseFiles);
+        }
+
+        // Layered parsing: consumes only this parser's options and moves every
+        // other token, in order, to the front of argv (after argv[0]), lowering
+        // argc for the next parser. Help requests, "@file" tokens, and "--" with
+        // everything after it are passed through. argv is only rearranged once
+        // the parse succeeds; on failure argc and argv are left untouched.
+        ParsingResult parseKnown(int& argc, char* argv[])
+        {
+            if (argc < 1)
+                return parse(argc, argv);
+
+            std::vector<int> kept;
+            mKept = &kept;
+            ParsingResult result = parseArgv(1, argc, argv, mResponseFiles);
+            mKept = nullptr;
+
+            if (result == PARSED_OK && static_cast<int>(kept.size()) + 1 < argc)
+            {
+                argc = 1;
+                for (int index : kept)
+                    argv[argc++] = argv[index];
+                argv[argc] = nullptr;
+            }
+            return result;
+        }
+
+        ParsingResult parseQuery(const std::string& query)
+        {
+            std::string copy = query;
+            return parseQuery(&copy[0], copy.size());
+        }
+
+        ParsingResult parseQuery(char* data, size_t length)
+        {
+            if (length > 0 && data[0] == '?')
+            {
+                ++data;
+                --length;
+            }
+
+            syncIndex(!mScanWhilePending);
+            clearExpansions();
+            mLimitExceeded = LIMIT_NONE;
+            if (mLimits.mMaxTotalBytes > 0 && length > mLimits.mMaxTotalBytes)
+                return exceedLimit(LIMIT_TOTAL_BYTES);
+            Budget budget = startBudget();
+
+            std::vector<std::pair<Option*, size_t>> touched;
+            std::string name;
+            char* end = data + length;
+
+            for (char* pair = data; pair < end; )
+            {
+                char* pairEnd = static_cast<char*>(std::memchr(pair, '&', end - pair));
+                if (pairEnd == nullptr)
+                    pairEnd = end;
+
+                char* separator = static_cast<char*>(std::memchr(pair, '=', pairEnd - pair));
+                char* keyEnd = separator != nullptr ? separator : pairEnd;
+                name.assign(pair, decodeUrlComponent(pair, keyEnd - pair));
+
+                const char* value = "";
+                size_t valueLength = 0;
+                if (separator != nullptr)
+                {
+                    value = separator + 1;
+                    valueLength = decodeUrlComponent(separator + 1, pairEnd - separator - 1);
+                }
+
+                pair = pairEnd == end ? end : pairEnd + 1;
+                if (name.empty())
+                    continue;
+
+                // Each pair is charged as one token, like a parse() token.
+                ++budget.mTokens;
+                if (mLimits.mMaxTokens > 0 && budget.mTokens > mLimits.mMaxTokens)
+                    return exceedLimit(LIMIT_TOKENS);
+                if (budget.mTimed && (budget.mTokens & 255) == 0 && std::chrono::steady_clock::now() > budget.mDeadline)
+                    return exceedLimit(LIMIT_TIME);
+                if (mLimits.mMaxValueLength > 0 && valueLength > mLimits.mMaxValueLength)
+                    return exceedLimit(LIMIT_VALUE_LENGTH);
+
+                std::string argId;
+                Option* opt = findQueryOption(name);
+                size_t dot = name.rfind('.');
+                if (opt == nullptr && dot != std::string::npos)
+                {
+                    argId = name.substr(dot + 1);
+                    name.resize(dot);
+                    opt = findQueryOption(name);
+                }
+
+                if (opt == nullptr)
+                {
+                    *mErrors << "Invalid argument {'" << name << "'}. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED;
+                }
+
+                size_t index = 0;
+                while (index < touched.size() && touched[index].first != opt)
+                    ++index;
+                if (index == touched.size())
+                    touched.push_back(std::make_pair(opt, 0));
+
+                if (opt->mArgsRef.empty())
+                {
+                    std::string flag(value, valueLength);
+                    if (flag == "0" || flag == "false" || flag == "off")
+                        touched.erase(touched.begin() + index);
+                    continue;
+                }
+
+                if (argId.empty())
+                {
+                    if (touched[index].second >= opt->mArgsRef.size())
+                    {
+                        *mErrors << "Too many values for parameter '" << name << "'. Please use --help for more information." << std::endl;
+                        return PARSED_FAILED;
+                    }
+                    opt->mArgsRef[touched[index].second++].mValue.assign(value, valueLength);
+                    continue;
+                }
+
+                if (opt->mArgsMap.find(argId) == opt->mArgsMap.end())
+                {
+                    *mErrors << "Invalid argument {'" << argId << "'} for parameter '" << name << "'. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED;
+                }
+                size_t slot = opt->mArgsMap[argId];
+                opt->mArgsRef[slot].mValue.assign(value, valueLength);
+                if (slot + 1 > touched[index].second)
+                    touched[index].second = slot + 1;
+            }
+
+            for (auto& entry : touched)
+            {
+                Option* opt = entry.first;
+                if (entry.second < opt->mArgsRef.size())
+                {
+                    *mErrors << "Missing argument {'" << opt->mArgsRef[entry.second].mId << "'} for parameter '" << opt->mOpts.front() << "'. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED;
+                }
+
+                ParsingResult result = commitOption(*opt, SOURCE_QUERY);
+                if (result != PARSED_OK)
+                    return result;
+            }
+
+            return checkMandatories();
+        }
+
+        const Option& operator () (const std::string& opt) const
+        {
+            const Option* found = findOption(opt);
+            if (found == nullptr)
+                throw ParsingException("Option Not Found!");
+            return *found;
+        }
+
+        // Value of an argument with ${name} and ${name.id} references replaced by
+        // the referenced option's value, or else by the environment variable.
+        // "$$" stands for "$". Each value is expanded once, on first access,
+        // and memoized until the next parse or reset().
+        const std::string& expanded(const std::string& opt, const std::string& id) const
+        {
+            const Option* found = findOption(opt);
+            if (found == nullptr)
+                throw ParsingException("Option Not Found!");
+            auto it = found->mArgsMap.find(id);
+            if (it == found->mArgsMap.end())
+                throw ParsingException("Invalid Argument");
+
+            std::vector<const Option::Argument*> active;
+            try
+            {
+                return expandArgument(found->mArgsRef[it->second], active);
+            }
+            catch (...)
+            {
+                for (auto arg : active)
+                    arg->mExpandState = EXPAND_NONE;
+                throw;
+            }
+        }
+
+#if CLI_HAS_FIXED_STRING
+        template <FixedString Opt>
+        const Option& get() const
+        {
+            static_assert(Opt.valid(), "Option names must be non-empty and contain no spaces");
+            return *static_cast<const Option*>(resolve(accessSlot<Opt>(), [this]() -> const void* {
+                return &(*this)(Opt.mData);
+            }));
+        }
+
+        template <FixedString Opt, FixedString Arg>
+        const std::string& get() const
+        {
+            static_assert(Opt.valid(), "Option names must be non-empty and contain no spaces");
+            static_assert(Arg.valid(), "Argument ids must be non-empty and contain no spaces");
+            return *static_cast<const std::string*>(resolve(accessSlot<Opt, Arg>(), [this]() -> const void* {
+                return &(*this)(Opt.mData).value(Arg.mData);
+            }));
+        }
+#endif
+
+    private:
+        std::string mProgram;
+        std::string mVersion;
+        std::string mDescription;
+        std::list<Option> mOptionRefs;
+        HashIndex<Option*> mOptionsMap;
+        std::ostream* mOutput;
+        std::ostream* mErrors;
+        Limits mLimits;
+        Limit mLimitExceeded;
+        bool mResponseFiles;
+        bool mParallelResolve;
+
+        struct DeprecatedAlias
+        {
+            std::string mTarget;
+            bool mWarned;
+        };
+        std::map<std::string, DeprecatedAlias> mDeprecatedAliases;
+
+        enum ExpandState
+        {
+            EXPAND_NONE,
+            EXPAND_ACTIVE,
+            EXPAND_DONE,
+        };
+
+        // Arena of expanded values; a deque keeps references stable as it grows.
+        mutable std::deque<std::string> mExpansions;
+        mutable bool mExpanding;
+        InternPool* mInternPool;
+        // Indices of passed-through tokens while parseKnown runs, otherwise null.
+        std::vector<int>* mKept;
+        FlightRecorder* mRecorder;
+
+        void record(FlightRecorder::EventKind kind, size_t token, size_t option, int depth) const
+        {
+            if (mRecorder != nullptr)
+                mRecorder->record(kind, token, option, depth);
+        }
+
+        void clearExpansions()
+        {
+            if (!mExpanding)
+                return;
+
+            for (auto& opt : mOptionRefs)
+            {
+                for (auto& arg : opt.mArgsRef)
+                    arg.mExpandState = EXPAND_NONE;
+            }
+            mExpansions.clear();
+            mExpanding = false;
+        }
+
+        // Depth-first walk of the reference graph; an argument still being
+        // expanded when it is reached again closes a cycle.
+        const std::string& expandArgument(const Option::Argument& arg, std::vector<const Option::Argument*>& active) const
+        {
+            static const size_t self = static_cast<size_t>(-1);
+            if (arg.mExpandState == EXPAND_DONE)
+                return arg.mExpansion == self ? arg.mValue : mExpansions[arg.mExpansion];
+            if (arg.mExpandState == EXPAND_ACTIVE)
+                throw ParsingException("Cyclic Reference");
+
+            mExpanding = true;
+            const std::string& value = arg.mValue;
+            if (value.find('$') == std::string::npos)
+            {
+                arg.mExpansion = self;
+                arg.mExpandState = EXPAND_DONE;
+                return value;
+            }
+
+            arg.mExpandState = EXPAND_ACTIVE;
+            active.push_back(&arg);
+
+            std::string result;
+            result.reserve(value.size());
+            size_t pos = 0;
+            while (pos < value.size())
+            {
+                size_t dollar = value.find('$', pos);
+                if (dollar == std::string::npos || dollar + 1 == value.size())
+                {
+                    result.append(value, pos, std::string::npos);
+                    break;
+                }
+
+                result.append(value, pos, dollar - pos);
+                pos = dollar + 1;
+                if (value[pos] == '$')
+                {
+                    result += '$';
+                    ++pos;
+                    continue;
+                }
+                if (value[pos] != '{')
+                {
+                    result += '$';
+                    continue;
+                }
+
+                size_t close = value.find('}', pos);
+                if (close == std::string::npos)
+                    throw ParsingException("Unterminated Reference");
+                appendReference(value.substr(pos + 1, close - pos - 1), result, active);
+                pos = close + 1;
+            }
+
+            mExpansions.push_back(std::move(result));
+            arg.mExpansion = mExpansions.size() - 1;
+            arg.mExpandState = EXPAND_DONE;
+            active.pop_back();
+            return mExpansions.back();
+        }
+
+        void appendReference(const std::string& name, std::string& result, std::vector<const Option::Argument*>& active) const
+        {
+            static const char* const prefixes[] = { "", "--", "-" };
+            size_t dot = name.rfind('.');
+            for (int split = 0; split < 2; ++split)
+            {
+                std::string key = split == 0 || dot == std::string::npos ? name : name.substr(0, dot);
+                for (const char* prefix : prefixes)
+                {
+                    const Option* opt = findOption(prefix + key);
+                    if (opt == nullptr || !opt->mProvided || opt->mArgsRef.empty())
+                        continue;
+
+                    size_t index = 0;
+                    if (split == 1)
+                    {
+                        auto it = opt->mArgsMap.find(name.substr(dot + 1));
+                        if (it == opt->mArgsMap.end())
+                            continue;
+                        index = it->second;
+                    }
+                    result += expandArgument(opt->mArgsRef[index], active);
+                    return;
+                }
+            }
+
+            const char* env = std::getenv(name.c_str());
+            if (env == nullptr)
+                throw ParsingException("Unresolved Reference");
+            result += env;
+        }
+
+        friend class FrozenOptions;
+        friend class ColumnCollector;
+
+        std::vector<Option*> mOptionsByIndex;
+        // Parsers attached to arguments, in option order, and the running
+        // hash of the options themselves; fingerprint() combines the two.
+        std::vector<const Parser*> mChildren;
+        uint64_t mSchemaHash;
+
+        static const uint64_t FINGERPRINT_SEED = 0x636C692D73636865ull;
+
+        static uint64_t hashOption(uint64_t hash, const Option& opt)
+        {
+            hash = KeyHash::mix(hash ^ opt.mOpts.size());
+            for (const auto& name : opt.mOpts)
+                hash = KeyHash::mix(hash ^ KeyHash::hash(name.data(), name.size(), FINGERPRINT_SEED));
+            hash = KeyHash::mix(hash ^ (opt.mRegistered != nullptr ? opt.mRegistered->mKind + 1 : 0));
+            hash = KeyHash::mix(hash ^ opt.mArgsRef.size());
+            for (const auto& arg : opt.mArgsRef)
+            {
+                hash = KeyHash::mix(hash ^ KeyHash::hash(arg.mId.data(), arg.mId.size(), FINGERPRINT_SEED));
+                hash = KeyHash::mix(hash ^ arg.mChecks);
+                hash = KeyHash::mix(hash ^ (arg.mChild != nullptr ? 1 : 0));
+            }
+            return hash;
+        }
+
+        // Bounds-checked reader for encoded commands.
+        class RecordReader
+        {
+        public:
+            RecordReader(const char* data, size_t length)
+                : mData(data)
+                , mLength(length)
+                , mOffset(0)
+            {
+            }
+
+            bool skip(size_t length)
+            {
+                if (length > mLength - mOffset)
+                    return false;
+                mOffset += length;
+                return true;
+            }
+
+            bool getU32(uint32_t& value)
+            {
+                if (4 > mLength - mOffset)
+                    return false;
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(mData + mOffset);
+                value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+                mOffset += 4;
+                return true;
+            }
+
+            bool getString(const char*& data, uint32_t& length)
+            {
+                if (!getU32(length) || length > mLength - mOffset)
+                    return false;
+                data = mData + mOffset;
+                mOffset += length;
+                return true;
+            }
+
+            bool done() const
+            {
+                return mOffset == mLength;
+            }
+
+        private:
+            const char* mData;
+            size_t mLength;
+            size_t mOffset;
+        };
+
+        ParsingResult invalidCommand()
+        {
+            *mErrors << "Invalid encoded command. Please use --help for more information." << std::endl;
+            return PARSED_FAILED;
+        }
+
+        static void appendToken(std::vector<char>& text, std::vector<size_t>& offsets, const char* data, size_t length)
+        {
+            offsets.push_back(text.size());
+            text.insert(text.end(), data, data + length);
+            text.push_back('\0');
+        }
+
+        // Bounded writer behind serialize(): it keeps counting past the end of
+        // the buffer so callers learn the size they need.
+        class RecordWriter
+        {
+        public:
+            RecordWriter(char* buffer, size_t capacity)
+                : mBuffer(buffer)
+                , mCapacity(capacity)
+                , mLength(0)
+            {
+            }
+
+            void put(const char* data, size_t length)
+            {
+                if (length <= mCapacity && mLength <= mCapacity - length)
+                    std::memcpy(mBuffer + mLength, data, length);
+                mLength += length;
+            }
+
+            void put(const char* text)
+            {
+                put(text, std::strlen(text));
+            }
+
+            void putU8(unsigned char value)
+            {
+                put(reinterpret_cast<const char*>(&value), 1);
+            }
+
+            void putU32(uint32_t value)
+            {
+                char bytes[4] = { static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+                put(bytes, 4);
+            }
+
+            void putString(const char* data, size_t length)
+            {
+                putU32(static_cast<uint32_t>(length));
+                put(data, length);
+            }
+
+            void patchU32(size_t offset, uint32_t value)
+            {
+                if (mLength > mCapacity)
+                    return;
+                size_t length = mLength;
+                mLength = offset;
+                putU32(value);
+                mLength = length;
+            }
+
+            // Quoted JSON string; runs that need no escaping are copied at once.
+            // Values that are not valid UTF-8 have every byte from 0x80 up
+            // escaped as \u00XX, so the record stays valid JSON.
+            void putJson(const char* data, size_t length)
+            {
+                static const char hex[] = "0123456789abcdef";
+                bool utf8 = checkValue(data, length, CHECK_UTF8);
+                put("\"", 1);
+                size_t run = 0;
+                for (size_t i = 0; i < length; ++i)
+                {
+                    unsigned char c = static_cast<unsigned char>(data[i]);
+                    if (c >= 0x20 && c != '"' && c != '\\' && (c < 0x80 || utf8))
+                        continue;
+
+                    put(data + run, i - run);
+                    run = i + 1;
+                    if (c == '"' || c == '\\')
+                    {
+                        char escaped[2] = { '\\', static_cast<char>(c) };
+                        put(escaped, 2);
+                    }
+                    else
+                    {
+                        char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+                        put(escaped, 6);
+                    }
+                }
+                put(data + run, length - run);
+                put("\"", 1);
+            }
+
+            size_t length() const
+            {
+                return mLength;
+            }
+
+        private:
+            char* mBuffer;
+            size_t mCapacity;
+            size_t mLength;
+        };
+
+        enum IndexState
+        {
+            INDEX_CURRENT,
+            INDEX_STALE,
+            INDEX_BUILDING,
+        };
+
+        struct Index
+        {
+            HashIndex<Option*> mOptions;
+            std::string mHelp;
+        };
+
+        IndexState mIndexState;
+        bool mDeferredIndexing;
+        bool mScanWhilePending;
+        std::string mHelp;
+        // Declared after the options it reads, so a pending build is joined
+        // before they are destroyed.
+        std::future<Index> mIndexing;
+
+        // Only reads the option names and descriptions, which parsing never
+        // modifies, so it can run concurrently with an early parse.
+        static Index buildIndex(const std::vector<Option*>& options)
+        {
+            Index index;
+            for (Option* opt : options)
+            {
+                for (const auto& name : opt->mOpts)
+                    index.mOptions.insert(name, opt);
+            }
+            return index;
+        }
+
+        // Runs on the background thread. It gets everything by value, and the
+        // option nodes stay in place when the parser is moved, so it never
+        // touches the parser object itself.
+        static Index buildIndexWithHelp(std::vector<Option*> options, std::string program, std::string version, std::string description)
+        {
+            Index index = buildIndex(options);
+            index.mHelp = composeHelp(program, version, description, options);
+            return index;
+        }
+
+        // Brings the lookup index up to date. Without wait, a pending background
+        // build is only adopted if it already finished.
+        bool syncIndex(bool wait)
+        {
+            if (mIndexState == INDEX_BUILDING)
+            {
+                if (!wait && mIndexing.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    return false;
+
+                Index index = mIndexing.get();
+                mOptionsMap.swap(index.mOptions);
+                mHelp.swap(index.mHelp);
+                mIndexState = INDEX_CURRENT;
+            }
+            else if (mIndexState == INDEX_STALE)
+            {
+                mOptionsMap = buildIndex(mOptionsByIndex).mOptions;
+                mIndexState = INDEX_CURRENT;
+            }
+            return true;
+        }
+
+        ParsingResult parseArgv(int first, int argc, char* argv[], bool responseFiles)
+        {
+            mLimitExceeded = LIMIT_NONE;
+            if (mLimits.mMaxTokens > 0 && argc > first && static_cast<size_t>(argc - first) > mLimits.mMaxTokens)
+                return exceedLimit(LIMIT_TOKENS);
+
+            syncIndex(!mScanWhilePending);
+            clearExpansions();
+            record(FlightRecorder::EVENT_PARSE_BEGIN, static_cast<size_t>(argc), 0, 0);
+            Budget budget = startBudget();
+            budget.mResponseFiles = responseFiles;
+            ParsingResult result = parseTokens(first, argc, argv, 0, budget);
+            if (result == PARSED_OK)
+                result = checkMandatories();
+
+            record(FlightRecorder::EVENT_PARSE_END, static_cast<size_t>(result), 0, 0);
+            return result;
+        }
+
+        // Parses a command line embedded in an argument value. Its first token
+        // is the program name, as argv[0] is for parse(). The tokens are split
+        // with the response file tokenizer in one scratch copy of the value,
+        // and the child then stores its values as parse() would.
+        ParsingResult parseEmbedded(const std::string& command)
+        {
+            std::vector<char> buffer(command.size() + 1, '\0');
+            std::memcpy(buffer.data(), command.data(), command.size());
+
+            std::vector<char*> tokens;
+            if (!ResponseFile::tokenize(buffer.data(), buffer.data() + command.size(), tokens))
+            {
+                *mErrors << "Unterminated quote in command {'" << command << "'}. Please use --help for more information." << std::endl;
+                return PARSED_FAILED;
+            }
+
+            reset();
+            return parseArgv(1, static_cast<int>(tokens.size()), tokens.data(), false);
+        }
+
+        struct Budget
+        {
+            size_t mTokens;
+            size_t mBytes;
+            bool mTimed;
+            std::chrono::steady_clock::time_point mDeadline;
+            // Whether "@path" tokens are expanded in this parse.
+            bool mResponseFiles;
+            // Response files being expanded, tracked when their depth is unlimited.
+            std::vector<std::string> mOpenFiles;
+        };
+
+        Budget startBudget() const
+        {
+            Budget budget;
+            budget.mTokens = 0;
+            budget.mBytes = 0;
+            budget.mTimed = mLimits.mTimeBudget.count() > 0;
+            budget.mResponseFiles = false;
+            if (budget.mTimed)
+                budget.mDeadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(mLimits.mTimeBudget);
+            return budget;
+        }
+
+        ParsingResult exceedLimit(Limit limit)
+        {
+            static const char* const names[] = { "none", "token count", "total bytes", "value length", "response file depth", "response file size", "time" };
+            mLimitExceeded = limit;
+            *mErrors << "Parse limit exceeded {'" << names[limit] << "'}. Please use --help for more information." << std::endl;
+            return PARSED_FAILED_LIMIT;
+        }
+
+        // Accounts one token against the configured limits. Lengths are only
+        // measured when a byte limit is set, and never past the remaining budget.
+        ParsingResult charge(Budget& budget, const char* token, bool value)
+        {
+            ++budget.mTokens;
+            if (mLimits.mMaxTokens > 0 && budget.mTokens > mLimits.mMaxTokens)
+                return exceedLimit(LIMIT_TOKENS);
+
+            const size_t unlimited = static_cast<size_t>(-1);
+            size_t valueLimit = value && mLimits.mMaxValueLength > 0 ? mLimits.mMaxValueLength : unlimited;
+            size_t bytesLimit = mLimits.mMaxTotalBytes > 0 ? mLimits.mMaxTotalBytes - budget.mBytes : unlimited;
+            size_t bound = std::min(valueLimit, bytesLimit);
+            if (bound != unlimited)
+            {
+                size_t length = 0;
+                while (length <= bound && token[length] != '\0')
+                    ++length;
+
+                if (length > valueLimit)
+                    return exceedLimit(LIMIT_VALUE_LENGTH);
+                if (length > bytesLimit)
+                    return exceedLimit(LIMIT_TOTAL_BYTES);
+                budget.mBytes += length;
+            }
+
+            if (budget.mTimed && (budget.mTokens & 255) == 0 && std::chrono::steady_clock::now() > budget.mDeadline)
+                return exceedLimit(LIMIT_TIME);
+
+            return PARSED_OK;
+        }
+
+        // Whether argv[first, argc) fits in the remaining token and byte budget.
+        // Checked before tokens are looked up in bulk, so an oversized input
+        // fails at its first excess token without being resolved first.
+        bool withinBudget(int first, int argc, char* argv[], const Budget& budget) const
+        {
+            if (mLimits.mMaxTokens > 0 && budget.mTokens + static_cast<size_t>(argc - first) > mLimits.mMaxTokens)
+                return false;
+            if (mLimits.mMaxTotalBytes == 0)
+                return true;
+
+            size_t left = mLimits.mMaxTotalBytes - budget.mBytes;
+            for (int i = first; i < argc; ++i)
+            {
+                size_t length = 0;
+                while (length <= left && argv[i][length] != '\0')
+                    ++length;
+                if (length > left)
+                    return false;
+                left -= length;
+            }
+            return true;
+        }
+
+        ParsingResult parseTokens(int first, int argc, char* argv[], int depth, Budget& budget)
+        {
+            std::vector<Option*> resolved;
+            if (mParallelResolve && argc - first > CLI_PARALLEL_PARSE_THRESHOLD && withinBudget(first, argc, argv, budget))
+                resolveTokens(first, argc, argv, resolved);
+
+            for (int i = first; i < argc; ++i)
+            {
+                const char* arg = argv[i];
+                ParsingResult charged = charge(budget, arg, false);
+                if (charged != PARSED_OK)
+                    return charged;
+
+                if (mKept == nullptr && isHelp(arg))
+                {
+                    record(FlightRecorder::EVENT_HELP, i, 0, depth);
+                    *mOutput << (mHelp.empty() ? composeHelpString() : mHelp) << std::endl;
+                    return PARSED_HELP;
+                }
+
+                Option* opt = resolved.empty() ? findOption(arg) : resolved[i];
+                if (opt == nullptr && !mDeprecatedAliases.empty())
+                    opt = findDeprecatedAlias(arg);
+
+                if (opt == nullptr && mKept != nullptr)
+                {
+                    record(FlightRecorder::EVENT_PASSTHROUGH, i, 0, depth);
+                    bool rest = std::strcmp(arg, "--") == 0;
+                    do
+                        mKept->push_back(i);
+                    while (rest && ++i < argc);
+                    continue;
+                }
+
+                if (opt == nullptr && arg[0] == '@' && budget.mResponseFiles)
+                {
+                    record(FlightRecorder::EVENT_RESPONSE_FILE, i, 0, depth);
+                    ParsingResult result = parseResponseFile(arg + 1, depth, budget);
+                    if (result != PARSED_OK)
+                        return result;
+                    continue;
+                }
+
+                if (opt == nullptr)
+                {
+                    record(FlightRecorder::EVENT_UNKNOWN, i, 0, depth);
+                    *mErrors << "Invalid argument {'" << arg << "'}. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED;
+                }
+
+                record(FlightRecorder::EVENT_OPTION, i, opt->mIndex, depth);
+                for (auto& innerArg : opt->mArgsRef)
+                {
+                    if (i + 1 >= argc)
+                    {
+                        *mErrors << "Missing argument {'" << innerArg.mId << "'} for parameter '" << arg << "'. Please use --help for more information." << std::endl;
+                        return PARSED_FAILED;
+                    }
+
+                    charged = charge(budget, argv[i + 1], true);
+                    if (charged != PARSED_OK)
+                        return charged;
+                    innerArg.mValue = argv[++i];
+                    record(FlightRecorder::EVENT_VALUE, i, opt->mIndex, depth);
+                }
+
+                ParsingResult result = commitOption(*opt, depth > 0 ? SOURCE_RESPONSE_FILE : SOURCE_COMMAND_LINE);
+                if (result != PARSED_OK)
+                    return result;
+            }
+
+            return PARSED_OK;
+        }
+
+        ParsingResult parseResponseFile(const char* path, int depth, Budget& budget)
+        {
+            if (mLimits.mMaxResponseFileDepth > 0 && static_cast<size_t>(depth) >= mLimits.mMaxResponseFileDepth)
+                return exceedLimit(LIMIT_RESPONSE_FILE_DEPTH);
+            if (budget.mTimed && std::chrono::steady_clock::now() > budget.mDeadline)
+                return exceedLimit(LIMIT_TIME);
+
+            ResponseFile file;
+            try
+            {
+                file.map(path);
+                if (mLimits.mMaxResponseFileSize > 0 && file.size() > mLimits.mMaxResponseFileSize)
+                    return exceedLimit(LIMIT_RESPONSE_FILE_SIZE);
+                file.split();
+            }
+            catch (const ParsingException& e)
+            {
+                *mErrors << "Invalid response file {'" << path << "'}: " << e.what() << ". Please use --help for more information." << std::endl;
+                return PARSED_FAILED;
+            }
+
+            // Without a depth limit, only a file that includes itself could
+            // recurse forever, so that is rejected instead.
+            bool tracked = mLimits.mMaxResponseFileDepth == 0;
+            if (tracked)
+            {
+                std::string identity = fileIdentity(path);
+                if (std::find(budget.mOpenFiles.begin(), budget.mOpenFiles.end(), identity) != budget.mOpenFiles.end())
+                {
+                    *mErrors << "Recursive response file {'" << path << "'}. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED;
+                }
+                budget.mOpenFiles.push_back(identity);
+            }
+
+            ParsingResult result = parseTokens(0, file.count(), file.tokens(), depth + 1, budget);
+            if (tracked)
+                budget.mOpenFiles.pop_back();
+            return result;
+        }
+
+        // Identifies a file independently of how its path is spelled, where the
+        // platform allows it.
+        static std::string fileIdentity(const char* path)
+        {
+#if CLI_HAS_MMAP
+            struct stat info;
+            if (::stat(path, &info) == 0)
+                return std::to_string(static_cast<unsigned long long>(info.st_dev)) + ':' + std::to_string(static_cast<unsigned long long>(info.st_ino));
+#endif
+            return path;
+        }
+
+        static bool isHelp(const char* arg)
+        {
+            return std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "/?") == 0;
+        }
+
+        Option* findOption(const std::string& arg) const
+        {
+            if (mIndexState != INDEX_CURRENT)
+            {
+                for (const auto& opt : mOptionRefs)
+                {
+                    for (const auto& name : opt.mOpts)
+                    {
+                        if (name == arg)
+                            return const_cast<Option*>(&opt);
+                    }
+                }
+                return nullptr;
+            }
+
+            return mOptionsMap.find(arg);
+        }
+
+        // First phase of a parse over a very large argv: every token is looked up
+        // as if it were an option, in parallel chunks. The sequential scan in
+        // parse() then only decides which tokens are consumed as arguments.
+        void resolveTokens(int first, int argc, char* argv[], std::vector<Option*>& resolved) const
+        {
+            resolved.assign(argc, nullptr);
+
+            size_t count = static_cast<size_t>(argc);
+            size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), std::max<size_t>(1, count / CLI_PARALLEL_PARSE_CHUNK));
+            size_t chunk = (count + workers - 1) / workers;
+
+            auto resolveRange = [this, first, argv, &resolved](size_t begin, size_t end) {
+                std::string token;
+                for (size_t i = std::max<size_t>(begin, first); i < end; ++i)
+                {
+                    token.assign(argv[i]);
+                    resolved[i] = findOption(token);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t begin = chunk; begin < count; begin += chunk)
+                threads.emplace_back(resolveRange, begin, std::min(count, begin + chunk));
+            resolveRange(0, std::min(count, chunk));
+
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        ParsingResult commitOption(Option& opt, Source source)
+        {
+            for (const auto& arg : opt.mArgsRef)
+            {
+                if (!(arg.mChecks & (CHECK_UTF8 | CHECK_NO_CONTROL)) || checkValue(arg.mValue.data(), arg.mValue.size(), arg.mChecks))
+                    continue;
+
+                *mErrors << "Invalid encoding in argument {'" << arg.mId << "'} for parameter '" << opt.mOpts.front() << "'. Please use --help for more information." << std::endl;
+                return PARSED_FAILED_VALIDATOR;
+            }
+
+            for (auto& arg : opt.mArgsRef)
+            {
+                arg.mFile.reset();
+                bool decoded = true;
+                if (arg.mChecks & DECODE_HEX)
+                    decoded = decodeHex(arg.mValue.data(), arg.mValue.size(), arg.mBytes);
+                else if (arg.mChecks & DECODE_BASE64)
+                    decoded = decodeBase64(arg.mValue.data(), arg.mValue.size(), arg.mBytes);
+                else if (arg.mChecks & TYPE_MASK)
+                    decoded = parseTyped(arg.mValue.data(), arg.mValue.size(), arg.mChecks, arg.mTyped);
+
+                if (!decoded)
+                {
+                    *mErrors << "Invalid " << valueKind(arg.mChecks) << " value in argument {'" << arg.mId << "'} for parameter '" << opt.mOpts.front() << "'. Please use --help for more information." << std::endl;
+                    return PARSED_FAILED_VALIDATOR;
+                }
+            }
+
+            if (opt.mValidator != nullptr && !opt.mValidator(opt))
+                return PARSED_FAILED_VALIDATOR;
+
+            if (opt.mRegistered != nullptr && !storeRegistered(*opt.mRegistered, opt))
+                return PARSED_FAILED_VALIDATOR;
+
+            for (auto& arg : opt.mArgsRef)
+            {
+                if (arg.mChild == nullptr)
+                    continue;
+
+                ParsingResult result = arg.mChild->parseEmbedded(arg.mValue);
+                if (result != PARSED_OK)
+                    return result;
+            }
+
+            if (mInternPool != nullptr)
+            {
+                for (auto& arg : opt.mArgsRef)
+                    arg.mInterned = mInternPool->intern(arg.mValue);
+            }
+
+            opt.mProvided = true;
+            opt.mSource = source;
+            return PARSED_OK;
+        }
+
+        // Text for string flags: each distinct value is kept once, in a pool
+        // that is created on first use and never destroyed, so flags outlive
+        // any parser and reset() without static constructors or destructors.
+        static const char* registeredText(const std::string& value)
+        {
+            static std::mutex* lock = new std::mutex();
+            static InternPool* pool = new InternPool();
+            std::lock_guard<std::mutex> guard(*lock);
+            return pool->data(pool->intern(value.c_str(), value.size() + 1));
+        }
+
+        // Writes a registered option to its typed global.
+        bool storeRegistered(const RegisteredOption& reg, Option& opt)
+        {
+            if (reg.mKind == RegisteredOption::KIND_BOOL)
+            {
+                *static_cast<bool*>(reg.mStorage) = true;
+                return true;
+            }
+
+            const std::string& value = opt.value("value");
+            if (reg.mKind == RegisteredOption::KIND_STRING)
+            {
+                *static_cast<const char**>(reg.mStorage) = registeredText(value);
+                return true;
+            }
+
+            char* end = nullptr;
+            errno = 0;
+            if (reg.mKind == RegisteredOption::KIND_INT)
+                *static_cast<long long*>(reg.mStorage) = std::strtoll(value.c_str(), &end, 10);
+            else
+                *static_cast<double*>(reg.mStorage) = std::strtod(value.c_str(), &end);
+
+            if (value.empty() || errno != 0 || *end != '\0')
+            {
+                *mErrors << "Invalid value {'" << value << "'} for parameter '" << reg.mName << "'. Please use --help for more information." << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        ParsingResult checkMandatories() const
+        {
+            for (auto& opt : mOptionRefs)
+            {
+                if (!opt.mMandatory || opt.mProvided)
+                    continue;
+
+                *mErrors << "Mandatory parameter {'" << opt.mOpts.front() << "'} not provided. Please use --help for more information." << std::endl;
+                return PARSED_FAILED;
+            }
+
+            return PARSED_OK;
+        }
+
+        Option* findQueryOption(const std::string& key)
+        {
+            static const char* const prefixes[] = { "", "--", "-" };
+            for (const char* prefix : prefixes)
+            {
+                Option* opt = findOption(prefix + key);
+                if (opt != nullptr)
+                    return opt;
+            }
+
+            for (const char* prefix : prefixes)
+            {
+                Option* opt = mDeprecatedAliases.empty() ? nullptr : findDeprecatedAlias(prefix + key);
+                if (opt != nullptr)
+                    return opt;
+            }
+            return nullptr;
+        }
+
+        // Only reached when the primary lookup missed, so aliases cost nothing on
+        // the normal path. Each alias is reported once per parser.
+        Option* findDeprecatedAlias(const std::string& arg)
+        {
+            auto it = mDeprecatedAliases.find(arg);
+            if (it == mDeprecatedAliases.end())
+                return nullptr;
+
+            Option* opt = findOption(it->second.mTarget);
+            if (opt != nullptr && !it->second.mWarned)
+            {
+                *mErrors << "Parameter '" << arg << "' is deprecated, please use '" << it->second.mTarget << "' instead." << std::endl;
+                it->second.mWarned = true;
+            }
+            return opt;
+        }
+
+        static unsigned countTrailingZeros(unsigned value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+        }
+
+        static int hexDigit(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        // Validates UTF-8 (rejecting overlongs, surrogates and code points past
+        // U+10FFFF) and/or the absence of C0, DEL and C1 control characters.
+        static bool checkValue(const char* value, size_t length, unsigned checks)
+        {
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(value);
+            bool noControl = (checks & CHECK_NO_CONTROL) != 0;
+            size_t i = 0;
+
+#if CLI_HAS_SSSE3
+            if (checks & CHECK_UTF8)
+                return checkUtf8Simd(data, length, noControl);
+#endif
+#if CLI_HAS_SSE2
+            const __m128i space = _mm_set1_epi8(0x20);
+            const __m128i del = _mm_set1_epi8(0x7F);
+            for (; i + 16 <= length; i += 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                if (_mm_movemask_epi8(chunk) != 0)
+                    break;
+                if (noControl && _mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, del))) != 0)
+                    return false;
+            }
+#endif
+
+            while (i < length)
+            {
+                unsigned c = data[i];
+                if (c < 0x80)
+                {
+                    if (noControl && (c < 0x20 || c == 0x7F))
+                        return false;
+                    ++i;
+                    continue;
+                }
+
+                if (!(checks & CHECK_UTF8))
+                {
+                    if (noControl && c == 0xC2 && i + 1 < length && data[i + 1] >= 0x80 && data[i + 1] < 0xA0)
+                        return false;
+                    ++i;
+                    continue;
+                }
+
+                size_t extra;
+                unsigned cp;
+                if (c >= 0xC2 && c <= 0xDF)
+                {
+                    extra = 1;
+                    cp = c & 0x1F;
+                }
+                else if (c >= 0xE0 && c <= 0xEF)
+                {
+                    extra = 2;
+                    cp = c & 0x0F;
+                }
+                else if (c >= 0xF0 && c <= 0xF4)
+                {
+                    extra = 3;
+                    cp = c & 0x07;
+                }
+                else
+                {
+                    return false;
+                }
+
+                if (length - i <= extra)
+                    return false;
+                for (size_t k = 1; k <= extra; ++k)
+                {
+                    if ((data[i + k] & 0xC0) != 0x80)
+                        return false;
+                    cp = (cp << 6) | (data[i + k] & 0x3F);
+                }
+
+                if (extra == 2 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF)))
+                    return false;
+                if (extra == 3 && (cp < 0x10000 || cp > 0x10FFFF))
+                    return false;
+                if (noControl && cp < 0xA0)
+                    return false;
+                i += extra + 1;
+            }
+
+            return true;
+        }
+
+#if CLI_HAS_SSSE3
+        // Lookup-table UTF-8 validation: the high and low nibble of each byte and
+        // the high nibble of the next one index three 16-entry tables whose AND
+        // flags every invalid two-byte pattern. Three and four byte sequences are
+        // checked by matching the expected continuation positions against them.
+        static bool checkUtf8Simd(const unsigned char* data, size_t length, bool noControl)
+        {
+            const unsigned char TOO_SHORT = 1 << 0;
+            const unsigned char TOO_LONG = 1 << 1;
+            const unsigned char OVERLONG_3 = 1 << 2;
+            const unsigned char TOO_LARGE = 1 << 3;
+            const unsigned char SURROGATE = 1 << 4;
+            const unsigned char OVERLONG_2 = 1 << 5;
+            const unsigned char TOO_LARGE_1000 = 1 << 6;
+            const unsigned char OVERLONG_4 = 1 << 6;
+            const unsigned char TWO_CONTS = 1 << 7;
+            const unsigned char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+            const __m128i byte1High = _mm_setr_epi8(
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                static_cast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4));
+            const __m128i byte1Low = _mm_setr_epi8(
+                static_cast<char>(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+                static_cast<char>(CARRY | OVERLONG_2),
+                static_cast<char>(CARRY),
+                static_cast<char>(CARRY),
+                static_cast<char>(CARRY | TOO_LARGE),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+                static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000));
+            const __m128i byte2High = _mm_setr_epi8(
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+                static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+                static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+                static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i space = _mm_set1_epi8(0x20);
+            const __m128i del = _mm_set1_epi8(0x7F);
+            const __m128i c2 = _mm_set1_epi8(static_cast<char>(0xC2));
+            const __m128i a0 = _mm_set1_epi8(static_cast<char>(0xA0));
+            const __m128i zero = _mm_setzero_si128();
+
+            __m128i previous = zero;
+            __m128i error = zero;
+            unsigned char tail[16];
+
+            // The last chunk is padded with spaces, which also flags a sequence
+            // truncated by the end of the value.
+            for (size_t i = 0; i <= length; i += 16)
+            {
+                __m128i input;
+                if (i + 16 <= length)
+                {
+                    input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                }
+                else
+                {
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, data + i, length - i);
+                    input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+                }
+
+                __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+                if (_mm_movemask_epi8(_mm_or_si128(input, prev1)) != 0)
+                {
+                    __m128i special = _mm_and_si128(
+                        _mm_and_si128(
+                            _mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                            _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, nibble))),
+                        _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+                    __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+                    __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+                    __m128i must23 = _mm_or_si128(
+                        _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                        _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+                    __m128i must23High = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+                    error = _mm_or_si128(error, _mm_xor_si128(must23High, special));
+
+                    if (noControl)
+                        error = _mm_or_si128(error, _mm_and_si128(_mm_cmpeq_epi8(prev1, c2), _mm_cmplt_epi8(input, a0)));
+                }
+
+                if (noControl)
+                {
+                    __m128i ascii = _mm_cmpgt_epi8(input, _mm_set1_epi8(-1));
+                    error = _mm_or_si128(error, _mm_and_si128(ascii, _mm_or_si128(_mm_cmplt_epi8(input, space), _mm_cmpeq_epi8(input, del))));
+                }
+
+                previous = input;
+            }
+
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF;
+        }
+#endif
+
+        // Decodes an even number of hex digits, 32 at a time with SSE2: both
+        // digit ranges are tested per byte and adjacent nibbles are merged
+        // in 16-bit lanes.
+        static bool decodeHex(const char* text, size_t length, AlignedBuffer& out)
+        {
+            if (length % 2 != 0)
+                return false;
+            return decodeHex(text, length, out.allocate(length / 2));
+        }
+
+        static bool decodeHex(const char* text, size_t length, unsigned char* data)
+        {
+            size_t read = 0;
+            size_t write = 0;
+
+#if CLI_HAS_SSE2
+            const __m128i digit0 = _mm_set1_epi8('0');
+            const __m128i alphaA = _mm_set1_epi8('a');
+            const __m128i lower = _mm_set1_epi8(0x20);
+            const __m128i none = _mm_set1_epi8(-1);
+            const __m128i ten = _mm_set1_epi8(10);
+            const __m128i six = _mm_set1_epi8(6);
+            const __m128i low = _mm_set1_epi16(0x00FF);
+
+            auto nibbles = [&](const char* src, __m128i& valid) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                __m128i digit = _mm_sub_epi8(chunk, digit0);
+                __m128i alpha = _mm_sub_epi8(_mm_or_si128(chunk, lower), alphaA);
+                __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digit, none), _mm_cmplt_epi8(digit, ten));
+                __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(alpha, none), _mm_cmplt_epi8(alpha, six));
+                valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isAlpha));
+                __m128i value = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isAlpha, _mm_add_epi8(alpha, ten)));
+                return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(value, low), 4), _mm_srli_epi16(value, 8));
+            };
+
+            for (; read + 32 <= length; read += 32, write += 16)
+            {
+                __m128i valid = none;
+                __m128i first = nibbles(text + read, valid);
+                __m128i second = nibbles(text + read + 16, valid);
+                if (_mm_movemask_epi8(valid) != 0xFFFF)
+                    return false;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + write), _mm_packus_epi16(first, second));
+            }
+#endif
+
+            for (; read < length; read += 2)
+            {
+                int high = hexDigit(text[read]);
+                int low = hexDigit(text[read + 1]);
+                if (high < 0 || low < 0)
+                    return false;
+                data[write++] = static_cast<unsigned char>(high << 4 | low);
+            }
+            return true;
+        }
+
+        static int base64Digit(char c)
+        {
+            if (c >= 'A' && c <= 'Z')
+                return c - 'A';
+            if (c >= 'a' && c <= 'z')
+                return c - 'a' + 26;
+            if (c >= '0' && c <= '9')
+                return c - '0' + 52;
+            if (c == '+')
+                return 62;
+            if (c == '/')
+                return 63;
+            return -1;
+        }
+
+        // Decodes standard base64, with or without '=' padding. With SSSE3, 16
+        // characters are validated and translated with nibble lookups and packed
+        // into 12 bytes per iteration.
+        static bool decodeBase64(const char* text, size_t length, AlignedBuffer& out)
+        {
+            if (length % 4 == 0 && length > 0 && text[length - 1] == '=')
+                length -= text[length - 2] == '=' ? 2 : 1;
+            if (length % 4 == 1)
+                return false;
+
+            unsigned char* data = out.allocate(length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1));
+            size_t read = 0;
+            size_t write = 0;
+
+#if CLI_HAS_SSSE3
+            const __m128i lutLow = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i lutHigh = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i mask2F = _mm_set1_epi8(0x2F);
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            for (; read + 16 <= length; read += 16, write += 12)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + read));
+                __m128i high = _mm_and_si128(_mm_srli_epi32(chunk, 4), mask2F);
+                __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lutLow, _mm_and_si128(chunk, mask2F)), _mm_shuffle_epi8(lutHigh, high));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, zero)) != 0xFFFF)
+                    return false;
+
+                __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(chunk, mask2F), high));
+                __m128i values = _mm_add_epi8(chunk, roll);
+                __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + write), _mm_shuffle_epi8(words, pack));
+            }
+#endif
+
+            unsigned bits = 0;
+            int pending = 0;
+            for (; read < length; ++read)
+            {
+                int digit = base64Digit(text[read]);
+                if (digit < 0)
+                    return false;
+
+                bits = (bits << 6) | static_cast<unsigned>(digit);
+                pending += 6;
+                if (pending >= 8)
+                {
+                    pending -= 8;
+                    data[write++] = static_cast<unsigned char>(bits >> pending);
+                }
+            }
+            return true;
+        }
+
+        static const char* valueKind(unsigned checks)
+        {
+            if (checks & DECODE_HEX)
+                return "hex";
+            if (checks & DECODE_BASE64)
+                return "base64";
+            if ((checks & TYPE_IPV4) && (checks & TYPE_IPV6))
+                return "IP address";
+            if (checks & TYPE_IPV4)
+                return "IPv4 address";
+            if (checks & TYPE_IPV6)
+                return "IPv6 address";
+            if (checks & TYPE_CIDR)
+                return "CIDR network";
+            if (checks & TYPE_PORT)
+                return "port";
+            if (checks & TYPE_UUID)
+                return "UUID";
+            if (checks & TYPE_TIMESTAMP)
+                return "timestamp";
+            return "MAC address";
+        }
+
+        // Leaves out empty when the value is rejected, whatever was parsed before the error.
+        static bool parseTyped(const char* text, size_t length, unsigned checks, TypedValue& out)
+        {
+            out = TypedValue();
+            if (parseTypedValue(text, length, checks, out))
+                return true;
+
+            out = TypedValue();
+            return false;
+        }
+
+        static bool parseTypedValue(const char* text, size_t length, unsigned checks, TypedValue& out)
+        {
+            bool colon = std::memchr(text, ':', length) != nullptr;
+            if (checks & (TYPE_IPV4 | TYPE_IPV6))
+            {
+                out.mFamily = (checks & TYPE_IPV6) && (colon || !(checks & TYPE_IPV4)) ? 6 : 4;
+                out.mPrefix = out.mFamily == 4 ? 32 : 128;
+                return out.mFamily == 4 ? parseIpv4(text, length, out.mData) : parseIpv6(text, length, out.mData);
+            }
+            if (checks & TYPE_CIDR)
+            {
+                const char* slash = static_cast<const char*>(std::memchr(text, '/', length));
+                if (slash == nullptr)
+                    return false;
+
+                size_t address = static_cast<size_t>(slash - text);
+                unsigned prefix = 0;
+                out.mFamily = colon ? 6 : 4;
+                if (!parseDecimal(slash + 1, length - address - 1, 3, prefix) || prefix > (colon ? 128u : 32u))
+                    return false;
+                out.mPrefix = static_cast<uint8_t>(prefix);
+                return colon ? parseIpv6(text, address, out.mData) : parseIpv4(text, address, out.mData);
+            }
+            if (checks & TYPE_PORT)
+            {
+                unsigned port = 0;
+                if (!parseDecimal(text, length, 5, port) || port > 65535)
+                    return false;
+                out.mPort = static_cast<uint16_t>(port);
+                return true;
+            }
+            if (checks & TYPE_UUID)
+                return parseUuid(text, length, out.mData);
+            if (checks & TYPE_TIMESTAMP)
+                return parseTimestamp(text, length, out.mSeconds, out.mNanoseconds);
+            return parseMac(text, length, out.mData);
+        }
+
+        // At most maxDigits decimal digits, without sign or leading zeros.
+        static bool parseDecimal(const char* text, size_t length, size_t maxDigits, unsigned& value)
+        {
+            if (length == 0 || length > maxDigits || (length > 1 && text[0] == '0'))
+                return false;
+
+            value = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+                if (digit > 9)
+                    return false;
+                value = value * 10 + digit;
+            }
+            return true;
+        }
+
+        // Dotted quad with decimal parts only, as inet_pton accepts it.
+        static bool parseIpv4(const char* text, size_t length, unsigned char* out)
+        {
+            size_t read = 0;
+            for (int part = 0; part < 4; ++part)
+            {
+                if (part > 0 && (read >= length || text[read++] != '.'))
+                    return false;
+
+                size_t start = read;
+                while (read < length && read - start < 3 && text[read] >= '0' && text[read] <= '9')
+                    ++read;
+
+                unsigned value = 0;
+                if (!parseDecimal(text + start, read - start, 3, value) || value > 255)
+                    return false;
+                out[part] = static_cast<unsigned char>(value);
+            }
+            return read == length;
+        }
+
+        // RFC 4291 text form: up to eight groups of one to four hex digits, one
+        // "::" run of zero groups and an optional trailing dotted quad.
+        static bool parseIpv6(const char* text, size_t length, unsigned char* out)
+        {
+            unsigned groups[8];
+            int count = 0;
+            int gap = -1;
+            size_t read = 0;
+
+            if (length >= 2 && text[0] == ':' && text[1] == ':')
+            {
+                gap = 0;
+                read = 2;
+            }
+
+            while (read < length)
+            {
+                size_t end = read;
+                while (end < length && text[end] != ':')
+                    ++end;
+
+                if (std::memchr(text + read, '.', end - read) != nullptr)
+                {
+                    unsigned char quad[4];
+                    if (end != length || count > 6 || !parseIpv4(text + read, end - read, quad))
+                        return false;
+                    groups[count++] = static_cast<unsigned>(quad[0] << 8 | quad[1]);
+                    groups[count++] = static_cast<unsigned>(quad[2] << 8 | quad[3]);
+                    break;
+                }
+
+                if (count == 8 || end == read || end - read > 4)
+                    return false;
+
+                unsigned group = 0;
+                for (; read < end; ++read)
+                {
+                    int digit = hexDigit(text[read]);
+                    if (digit < 0)
+                        return false;
+                    group = group << 4 | static_cast<unsigned>(digit);
+                }
+                groups[count++] = group;
+
+                if (read == length)
+                    break;
+                if (++read == length)
+                    return false;
+                if (text[read] == ':')
+                {
+                    if (gap >= 0)
+                        return false;
+                    gap = count;
+                    ++read;
+                }
+            }
+
+            if (gap < 0 ? count != 8 : count > 7)
+                return false;
+
+            int zeros = 8 - count;
+            for (int i = 0, group = 0; i < 8; ++i)
+            {
+                unsigned value = 0;
+                if (gap < 0 || i < gap || i >= gap + zeros)
+                    value = groups[group++];
+                out[2 * i] = static_cast<unsigned char>(value >> 8);
+                out[2 * i + 1] = static_cast<unsigned char>(value);
+            }
+            return true;
+        }
+
+        // 8-4-4-4-12 hex digits. The groups are joined into one 32-digit run so
+        // the SSE2 hex decoder handles them in a single step.
+        static bool parseUuid(const char* text, size_t length, unsigned char* out)
+        {
+            if (length != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-')
+                return false;
+
+            char digits[32];
+            std::memcpy(digits, text, 8);
+            std::memcpy(digits + 8, text + 9, 4);
+            std::memcpy(digits + 12, text + 14, 4);
+            std::memcpy(digits + 16, text + 19, 4);
+            std::memcpy(digits + 20, text + 24, 12);
+            return decodeHex(digits, sizeof(digits), out);
+        }
+
+        // Six hex pairs separated consistently by ':' or '-'.
+        static bool parseMac(const char* text, size_t length, unsigned char* out)
+        {
+            if (length != 17 || (text[2] != ':' && text[2] != '-'))
+                return false;
+
+            for (size_t i = 0; i < 6; ++i)
+            {
+                int high = hexDigit(text[3 * i]);
+                int low = hexDigit(text[3 * i + 1]);
+                if (high < 0 || low < 0 || (i < 5 && text[3 * i + 2] != text[2]))
+                    return false;
+                out[i] = static_cast<unsigned char>(high << 4 | low);
+            }
+            return true;
+        }
+
+        static bool parseDigits(const char* text, size_t count, int& value)
+        {
+            value = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+                if (digit > 9)
+                    return false;
+                value = value * 10 + static_cast<int>(digit);
+            }
+            return true;
+        }
+
+        // Days from 1970-01-01 to a proleptic Gregorian date.
+        static int64_t daysFromCivil(int year, int month, int day)
+        {
+            year -= month <= 2;
+            int era = (year >= 0 ? year : year - 399) / 400;
+            int yearOfEra = year - era * 400;
+            int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return static_cast<int64_t>(era) * 146097 + dayOfEra - 719468;
+        }
+
+        // RFC 3339 / ISO 8601 extended form: a date alone, or a date and time
+        // with 'T', 't' or ' ', optional fraction up to nanoseconds and a
+        // required 'Z' or +HH:MM offset. A leap second (second 60) is accepted
+        // and, as in POSIX time, counts as the first second of the next minute.
+        static bool parseTimestamp(const char* text, size_t length, int64_t& seconds, uint32_t& nanoseconds)
+        {
+            static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            int year, month, day;
+            int hour = 0, minute = 0, second = 0, offset = 0;
+            uint32_t fraction = 0;
+
+            if (length < 10 || text[4] != '-' || text[7] != '-' || !parseDigits(text, 4, year) || !parseDigits(text + 5, 2, month) || !parseDigits(text + 8, 2, day))
+                return false;
+
+            bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+            if (month < 1 || month > 12 || day < 1 || day > days[month - 1] + (month == 2 && leap ? 1 : 0))
+                return false;
+
+            if (length > 10)
+            {
+                char separator = text[10];
+                if ((separator != 'T' && separator != 't' && separator != ' ') || length < 19 || text[13] != ':' || text[16] != ':'
+                    || !parseDigits(text + 11, 2, hour) || !parseDigits(text + 14, 2, minute) || !parseDigits(text + 17, 2, second)
+                    || hour > 23 || minute > 59 || second > 60)
+                    return false;
+
+                size_t read = 19;
+                if (read < length && text[read] == '.')
+                {
+                    size_t start = ++read;
+                    uint32_t scale = 100000000;
+                    for (; read < length && text[read] >= '0' && text[read] <= '9'; ++read, scale /= 10)
+                    {
+                        if (read - start == 9)
+                            return false;
+                        fraction += static_cast<uint32_t>(text[read] - '0') * scale;
+                    }
+                    if (read == start)
+                        return false;
+                }
+
+                if (read + 1 == length && (text[read] == 'Z' || text[read] == 'z'))
+                {
+                    offset = 0;
+                }
+                else
+                {
+                    int offsetHour, offsetMinute;
+                    if (read + 6 != length || (text[read] != '+' && text[read] != '-') || text[read + 3] != ':'
+                        || !parseDigits(text + read + 1, 2, offsetHour) || !parseDigits(text + read + 4, 2, offsetMinute)
+                        || offsetHour > 23 || offsetMinute > 59)
+                        return false;
+                    offset = (offsetHour * 60 + offsetMinute) * 60 * (text[read] == '-' ? -1 : 1);
+                }
+            }
+
+            seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+            nanoseconds = fraction;
+            return true;
+        }
+
+        // Decodes '+' and %XX escapes in place and returns the decoded length.
+        // Runs without escapes are skipped (and shifted down) 16 bytes at a time.
+        static size_t decodeUrlComponent(char* data, size_t length)
+        {
+            size_t read = 0;
+            size_t write = 0;
+
+            while (read < length)
+            {
+#if CLI_HAS_SSE2
+                const __m128i percent = _mm_set1_epi8('%');
+                const __m128i plus = _mm_set1_epi8('+');
+                while (read + 16 <= length)
+                {
+                    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + read));
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, percent), _mm_cmpeq_epi8(chunk, plus))));
+                    if (mask != 0)
+                    {
+                        unsigned skip = countTrailingZeros(mask);
+                        if (write != read)
+                            std::memmove(data + write, data + read, skip);
+                        read += skip;
+                        write += skip;
+                        break;
+                    }
+
+                    if (write != read)
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + write), chunk);
+                    read += 16;
+                    write += 16;
+                }
+
+                if (read >= length)
+                    break;
+#endif
+                char c = data[read];
+                int high = -1;
+                int low = -1;
+                if (c == '%' && read + 2 < length)
+                {
+                    high = hexDigit(data[read + 1]);
+                    low = hexDigit(data[read + 2]);
+                }
+
+                if (c == '+')
+                {
+                    data[write++] = ' ';
+                    ++read;
+                }
+                else if (high >= 0 && low >= 0)
+                {
+                    data[write++] = static_cast<char>((high << 4) | low);
+                    read += 3;
+                }
+                else
+                {
+                    data[write++] = data[read++];
+                }
+            }
+
+            return write;
+        }
+#if CLI_HAS_FIXED_STRING
+        // Fixed table of resolved get<...> targets. Readers racing on a slot store
+        // the same pointer atomically, so const access stays safe from many
+        // threads. Copies start empty, since the pointers belong to the source.
+        class AccessCache
+        {
+        public:
+            AccessCache()
+            {
+                clear();
+            }
+
+            AccessCache(const AccessCache&)
+            {
+                clear();
+            }
+
+            AccessCache& operator = (const AccessCache&)
+            {
+                clear();
+                return *this;
+            }
+
+            void clear()
+            {
+                for (auto& slot : mSlots)
+                    slot.store(nullptr, std::memory_order_relaxed);
+            }
+
+            const void* load(size_t slot) const
+            {
+                return slot < CLI_ACCESS_CACHE_SLOTS ? mSlots[slot].load(std::memory_order_acquire) : nullptr;
+            }
+
+            void store(size_t slot, const void* target) const
+            {
+                if (slot < CLI_ACCESS_CACHE_SLOTS)
+                    mSlots[slot].store(target, std::memory_order_release);
+            }
+
+        private:
+            mutable std::atomic<const void*> mSlots[CLI_ACCESS_CACHE_SLOTS];
+        };
+
+        AccessCache mAccessCache;
+
+        static size_t nextAccessSlot()
+        {
+            static std::atomic<size_t> counter(0);
+            return counter++;
+        }
+
+        template <FixedString... Names>
+        static size_t accessSlot()
+        {
+            static const size_t slot = nextAccessSlot();
+            return slot;
+        }
+
+        // Each get<...> instantiation owns one slot; the first call on a parser
+        // does the string lookups and later calls are a single atomic load.
+        // Instantiations past CLI_ACCESS_CACHE_SLOTS look the names up every time.
+        template <typename Lookup>
+        const void* resolve(size_t slot, Lookup lookup) const
+        {
+            const void* target = mAccessCache.load(slot);
+            if (target != nullptr)
+                return target;
+
+            target = lookup();
+            mAccessCache.store(slot, target);
+            return target;
+        }
+#endif
+    };
+
+    class FrozenOptions
+    {
+    public:
+        class Replica
+        {
+        public:
+            bool provided(size_t option) const
+            {
+                return mProvided[option] != 0;
+            }
+
+            const char* value(size_t slot) const
+            {
+                return mChars + mOffsets[slot];
+            }
+
+            size_t length(size_t slot) const
+            {
+                return mOffsets[slot + 1] - mOffsets[slot] - 1;
+            }
+
+        private:
+            std::unique_ptr<size_t[]> mBlock;
+            const size_t* mOffsets;
+            const unsigned char* mProvided;
+            const char* mChars;
+
+            friend class FrozenOptions;
+        };
+
+        explicit FrozenOptions(const Parser& parser)
+            : mId(nextId())
+        {
+            std::vector<unsigned char> provided;
+            std::vector<size_t> offsets;
+            std::string chars;
+
+            for (auto& opt : parser.mOptionRefs)
+            {
+                for (auto& name : opt.mOpts)
+                    mOptionSlots.insert(std::make_pair(name, provided.size()));
+                provided.push_back(opt.mProvided ? 1 : 0);
+
+                for (auto& arg : opt.mArgsRef)
+                {
+                    for (auto& name : opt.mOpts)
+                        mValueSlots.insert(std::make_pair(name + '\0' + arg.mId, offsets.size()));
+                    offsets.push_back(chars.size());
+                    chars.append(arg.mValue);
+                    chars.push_back('\0');
+                }
+            }
+            offsets.push_back(chars.size());
+
+            mOffsetCount = offsets.size();
+            mProvidedCount = provided.size();
+            mImage.resize(mOffsetCount * sizeof(size_t) + mProvidedCount + chars.size());
+            std::memcpy(&mImage[0], offsets.data(), mOffsetCount * sizeof(size_t));
+            if (!provided.empty())
+                std::memcpy(&mImage[mOffsetCount * sizeof(size_t)], provided.data(), mProvidedCount);
+            if (!chars.empty())
+                std::memcpy(&mImage[mOffsetCount * sizeof(size_t) + mProvidedCount], chars.data(), chars.size());
+
+            for (auto& replica : mReplicas)
+                replica.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~FrozenOptions()
+        {
+            for (auto& replica : mReplicas)
+                delete replica.load(std::memory_order_acquire);
+        }
+
+        size_t optionSlot(const std::string& opt) const
+        {
+            auto it = mOptionSlots.find(opt);
+            if (it == mOptionSlots.end())
+                throw ParsingException("Option Not Found!");
+            return it->second;
+        }
+
+        size_t valueSlot(const std::string& opt, const std::string& arg) const
+        {
+            auto it = mValueSlots.find(opt + '\0' + arg);
+            if (it == mValueSlots.end())
+                throw ParsingException("Invalid Argument");
+            return it->second;
+        }
+
+        // Returns the copy of the snapshot that lives on the calling thread's NUMA
+        // node. The first reader on a node builds that copy, so first-touch page
+        // placement puts it in local memory; later reads hit a thread-local cache.
+        const Replica& local() const
+        {
+            struct Cache
+            {
+                unsigned long long mId;
+                const Replica* mReplica;
+            };
+            static thread_local Cache cache = { 0, nullptr };
+
+            if (cache.mId == mId)
+                return *cache.mReplica;
+
+            std::atomic<Replica*>& slot = mReplicas[currentNode() % CLI_MAX_NUMA_NODES];
+            Replica* replica = slot.load(std::memory_order_acquire);
+            if (replica == nullptr)
+            {
+                Replica* fresh = makeReplica();
+                if (slot.compare_exchange_strong(replica, fresh, std::memory_order_acq_rel))
+                    replica = fresh;
+                else
+                    delete fresh;
+            }
+
+            cache.mId = mId;
+            cache.mReplica = replica;
+            return *replica;
+        }
+
+        static unsigned currentNode()
+        {
+#if defined(__linux__)
+            static thread_local int node = -1;
+            if (node >= 0)
+                return static_cast<unsigned>(node);
+
+            node = 0;
+            int cpu = sched_getcpu();
+            if (cpu < 0)
+                return 0;
+
+            std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+            DIR* dir = opendir(path.c_str());
+            if (dir == nullptr)
+                return 0;
+            while (dirent* entry = readdir(dir))
+            {
+                if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+                {
+                    node = std::atoi(entry->d_name + 4);
+                    break;
+                }
+            }
+            closedir(dir);
+            return static_cast<unsigned>(node);
+#else
+            return 0;
+#endif
+        }
+
+    private:
+        unsigned long long mId;
+        std::map<std::string, size_t> mOptionSlots;
+        std::map<std::string, size_t> mValueSlots;
+        std::string mImage;
+        size_t mOffsetCount;
+        size_t mProvidedCount;
+        mutable std::atomic<Replica*> mReplicas[CLI_MAX_NUMA_NODES];
+
+        FrozenOptions(const FrozenOptions&);
+        FrozenOptions& operator = (const FrozenOptions&);
+
+        static unsigned long long nextId()
+        {
+            static std::atomic<unsigned long long> counter(0);
+            return ++counter;
+        }
+
+        Replica* makeReplica() const
+        {
+            Replica* replica = new Replica();
+            replica->mBlock.reset(new size_t[(mImage.size() + sizeof(size_t) - 1) / sizeof(size_t) + 1]);
+            char* base = reinterpret_cast<char*>(replica->mBlock.get());
+            std::memcpy(base, mImage.data(), mImage.size());
+            replica->mOffsets = reinterpret_cast<const size_t*>(base);
+            replica->mProvided = reinterpret_cast<const unsigned char*>(base + mOffsetCount * sizeof(size_t));
+            replica->mChars = base + mOffsetCount * sizeof(size_t) + mProvidedCount;
+            return replica;
+        }
+    };
+
+    inline std::shared_ptr<const FrozenOptions> Parser::freeze() const
+    {
+        return std::make_shared<FrozenOptions>(*this);
+    }
+
+    // Appends parse results into one column per option and per argument, laid
+    // out as Arrow arrays: bitmaps are LSB first, offsets are int32 with one
+    // extra entry, and a cleared validity bit marks a null. Presence columns
+    // are boolean arrays; argument columns are dictionary<int32, utf8> by
+    // default, or int64/double arrays where values that do not parse are null.
+    class ColumnCollector
+    {
+    public:
+        enum ColumnType
+        {
+            COLUMN_PRESENCE,
+            COLUMN_DICTIONARY,
+            COLUMN_INT64,
+            COLUMN_DOUBLE,
+        };
+
+        struct Column
+        {
+            std::string mOption;
+            std::string mArgument;
+            ColumnType mType;
+            size_t mNullCount;
+            std::vector<uint8_t> mValidity;
+            std::vector<uint8_t> mBits;
+            std::vector<int32_t> mIndices;
+            std::vector<int64_t> mInt64;
+            std::vector<double> mDouble;
+            std::vector<int32_t> mDictionaryOffsets;
+            std::vector<char> mDictionaryData;
+            IdTable mDictionary;
+        };
+
+        // Takes the schema from parser; every appended parser must share it.
+        explicit ColumnCollector(const Parser& parser)
+            : mRows(0)
+        {
+            for (const auto& opt : parser.mOptionRefs)
+            {
+                addColumn(opt.mOpts.front(), "", COLUMN_PRESENCE);
+                for (const auto& arg : opt.mArgsRef)
+                    addColumn(opt.mOpts.front(), arg.mId, COLUMN_DICTIONARY);
+            }
+        }
+
+        // Only allowed before the first row is appended.
+        void setType(const std::string& opt, const std::string& id, ColumnType type)
+        {
+            if (mRows > 0 || type == COLUMN_PRESENCE || id.empty())
+                throw ParsingException("Invalid Column Type");
+            find(opt, id).mType = type;
+        }
+
+        void append(const Parser& parser)
+        {
+            size_t index = 0;
+            for (const auto& opt : parser.mOptionRefs)
+            {
+                if (index + 1 + opt.mArgsRef.size() > mColumns.size() || mColumns[index].mOption != opt.mOpts.front())
+                    throw ParsingException("Schema Mismatch");
+
+                setBit(mColumns[index].mBits, opt.mProvided);
+                setBit(mColumns[index++].mValidity, true);
+                for (const auto& arg : opt.mArgsRef)
+                    appendValue(mColumns[index++], opt.mProvided, arg.mValue);
+            }
+
+            if (index != mColumns.size())
+                throw ParsingException("Schema Mismatch");
+            ++mRows;
+        }
+
+        size_t rows() const
+        {
+            return mRows;
+        }
+
+        const std::vector<Column>& columns() const
+        {
+            return mColumns;
+        }
+
+        // The presence column of opt when id is empty.
+        const Column& column(const std::string& opt, const std::string& id = "") const
+        {
+            return const_cast<ColumnCollector*>(this)->find(opt, id);
+        }
+
+    private:
+        // Dictionary entries as keys of the column's IdTable.
+        struct DictionaryKeys
+        {
+            const Column* mColumn;
+
+            const char* data(uint32_t id) const
+            {
+                return mColumn->mDictionaryData.data() + mColumn->mDictionaryOffsets[id];
+            }
+
+            size_t size(uint32_t id) const
+            {
+                return static_cast<size_t>(mColumn->mDictionaryOffsets[id + 1] - mColumn->mDictionaryOffsets[id]);
+            }
+        };
+
+        std::vector<Column> mColumns;
+        size_t mRows;
+
+        void addColumn(const std::string& opt, const std::string& id, ColumnType type)
+        {
+            Column column;
+            column.mOption = opt;
+            column.mArgument = id;
+            column.mType = type;
+            column.mNullCount = 0;
+            column.mDictionaryOffsets.push_back(0);
+            mColumns.push_back(column);
+        }
+
+        Column& find(const std::string& opt, const std::string& id)
+        {
+            for (auto& column : mColumns)
+            {
+                if (column.mArgument == id && column.mOption == opt)
+                    return column;
+            }
+            throw ParsingException("Column Not Found!");
+        }
+
+        void setBit(std::vector<uint8_t>& bitmap, bool value)
+        {
+            if (mRows % 8 == 0)
+                bitmap.push_back(0);
+            if (value)
+                bitmap.back() |= static_cast<uint8_t>(1u << (mRows % 8));
+        }
+
+        void appendValue(Column& column, bool provided, const std::string& value)
+        {
+            bool valid = provided;
+            char* end = nullptr;
+            errno = 0;
+
+            switch (column.mType)
+            {
+            case COLUMN_INT64:
+            {
+                long long number = valid ? std::strtoll(value.c_str(), &end, 10) : 0;
+                valid = valid && !value.empty() && errno == 0 && *end == '\0';
+                column.mInt64.push_back(valid ? number : 0);
+                break;
+            }
+            case COLUMN_DOUBLE:
+            {
+                double number = valid ? std::strtod(value.c_str(), &end) : 0.0;
+                valid = valid && !value.empty() && errno == 0 && *end == '\0';
+                column.mDouble.push_back(valid ? number : 0.0);
+                break;
+            }
+            default:
+            {
+                uint32_t entry = 0;
+                if (valid)
+                {
+                    DictionaryKeys keys = { &column };
+                    uint64_t hash = column.mDictionary.hash(value.data(), value.size());
+                    entry = column.mDictionary.find(hash, value.data(), value.size(), keys);
+                    if (entry == IdTable::npos)
+                    {
+                        column.mDictionaryData.insert(column.mDictionaryData.end(), value.begin(), value.end());
+                        column.mDictionaryOffsets.push_back(static_cast<int32_t>(column.mDictionaryData.size()));
+                        entry = static_cast<uint32_t>(column.mDictionary.size());
+                        column.mDictionary.insert(hash, keys);
+                    }
+                }
+                column.mIndices.push_back(static_cast<int32_t>(entry));
+                break;
+            }
+            }
+
+            setBit(column.mValidity, valid);
+            if (!valid)
+                ++column.mNullCount;
+        }
+    };
+
+    class BatchSink
+    {
+    public:
+        explicit BatchSink(std::FILE* file, size_t capacity = 1 << 16)
+            : mFile(file)
+            , mBuffer(capacity)
+            , mUsed(0)
+        {
+        }
+
+        ~BatchSink()
+        {
+            flush();
+        }
+
+        void write(const char* data, size_t length)
+        {
+            if (length > mBuffer.size() - mUsed)
+            {
+                flush();
+                if (length > mBuffer.size())
+                {
+                    std::fwrite(data, 1, length, mFile);
+                    return;
+                }
+            }
+
+            std::memcpy(mBuffer.data() + mUsed, data, length);
+            mUsed += length;
+        }
+
+        void write(const std::string& value)
+        {
+            write(value.data(), value.size());
+        }
+
+        void flush()
+        {
+            if (mUsed > 0)
+                std::fwrite(mBuffer.data(), 1, mUsed, mFile);
+            mUsed = 0;
+            std::fflush(mFile);
+        }
+
+    private:
+        std::FILE* mFile;
+        std::vector<char> mBuffer;
+        size_t mUsed;
+    };
+
+    class BatchDriver
+    {
+    public:
+        typedef std::function<bool(Parser& parser, BatchSink& output)> Handler;
+
+        BatchDriver(Parser& parser, Handler handler, size_t blockSize = CLI_BATCH_BLOCK_SIZE)
+            : mParser(parser)
+            , mHandler(handler)
+            , mBlockSize(blockSize)
+        {
+        }
+
+        // Reads newline separated command lines from input until EOF and returns
+        // the number of lines that failed to parse or whose handler returned false.
+        size_t run(std::FILE* input = stdin, std::FILE* output = stdout, std::FILE* errors = stderr)
+        {
+            BatchSink out(output);
+            BatchSink err(errors);
+            std::ostringstream diagnostics;
+            StreamGuard streams(mParser);
+            mParser.setStreams(diagnostics, diagnostics);
+
+            std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+            shared->mFree.push_back(&shared->mBlocks[0]);
+            shared->mFree.push_back(&shared->mBlocks[1]);
+            shared->mStop = false;
+
+            std::thread reader(&BatchDriver::readBlocks, shared, input, mBlockSize);
+            size_t failures = 0;
+
+            try
+            {
+                for (;;)
+                {
+                    Block* block = nullptr;
+                    {
+                        std::unique_lock<std::mutex> lock(shared->mMutex);
+                        shared->mCondition.wait(lock, [&shared]() { return !shared->mReady.empty(); });
+                        block = shared->mReady.front();
+                        shared->mReady.pop_front();
+                    }
+
+                    for (auto& line : block->mLines)
+                    {
+                        diagnostics.str(std::string());
+                        mParser.reset();
+
+                        char** argv = block->mTokens.data() + line.mFirstToken;
+                        Parser::ParsingResult result = line.mValid ? mParser.parse(static_cast<int>(line.mTokenCount), argv) : Parser::PARSED_FAILED;
+                        if (!line.mValid)
+                            diagnostics << "Unterminated quote." << std::endl;
+
+                        if (result == Parser::PARSED_OK && (mHandler == nullptr || mHandler(mParser, out)))
+                            continue;
+                        if (result == Parser::PARSED_HELP)
+                        {
+                            out.write(diagnostics.str());
+                            continue;
+                        }
+
+                        ++failures;
+                        std::string message = "line " + std::to_string(line.mNumber) + ": " + diagnostics.str();
+                        if (result == Parser::PARSED_OK && diagnostics.str().empty())
+                            message += "Command failed.";
+                        if (message.back() != '\n')
+                            message += '\n';
+                        err.write(message);
+                    }
+
+                    bool last = block->mLast;
+                    {
+                        std::lock_guard<std::mutex> lock(shared->mMutex);
+                        shared->mFree.push_back(block);
+                    }
+                    shared->mCondition.notify_all();
+
+                    if (last)
+                        break;
+                }
+            }
+            catch (...)
+            {
+                // The reader may be blocked in fread on input that never ends, so it
+                // is not joined: it owns the shared state and exits, discarding its
+                // block, as soon as the read returns.
+                {
+                    std::lock_guard<std::mutex> lock(shared->mMutex);
+                    shared->mStop = true;
+                }
+                shared->mCondition.notify_all();
+                reader.detach();
+                throw;
+            }
+
+            reader.join();
+            return failures;
         }
+
     private:
-        std::string mMessage;
-    };
+        struct Line
+        {
+            size_t mNumber;
+            size_t mFirstToken;
+            size_t mTokenCount;
+            bool mValid;
+        };
 
-    class Parser
-    {
-    public:
-        enum ParsingResult
+        struct Block
         {
-            PARSED_OK = 0,
-            PARSED_HELP = 1,
-            PARSED_FAILED = -2,
-            PARSED_FAILED_VALIDATOR = -3,
+            std::vector<char> mData;
+            std::vector<char*> mTokens;
+            std::vector<Line> mLines;
+            bool mLast;
         };
 
-        class Option
+        // Everything the reader thread touches, kept alive by whichever of the
+        // two threads finishes last.
+        struct Shared
+        {
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::deque<Block*> mFree;
+            std::deque<Block*> mReady;
+            bool mStop;
+            Block mBlocks[2];
+        };
+
+        // Restores the streams the caller had set on the parser.
+        class StreamGuard
         {
         public:
+            explicit StreamGuard(Parser& parser)
+                : mParser(parser)
+                , mOutput(parser.outputStream())
+                , mErrors(parser.errorStream())
+            {
+            }
 
-            class Argument
+            ~StreamGuard()
             {
-            public:
-                Argument(const std::string& id, const std::string& desc)
-                    : mId(id)
-                    , mDesc(desc)
-                {}
+                mParser.setStreams(mOutput, mErrors);
+            }
 
-            private:
-                std::string mId;
-                std::string mDesc;
-                std::string mValue;
+        private:
+            Parser& mParser;
+            std::ostream& mOutput;
+            std::ostream& mErrors;
+        };
 
-                friend class Parser;
+        Parser& mParser;
+        Handler mHandler;
+        size_t mBlockSize;
+
+        // Runs on its own thread: fills the next block and splits it into lines
+        // and tokens while the caller's thread parses and handles the previous one.
+        static void readBlocks(std::shared_ptr<Shared> shared, std::FILE* input, size_t blockSize)
+        {
+            std::string carry;
+            size_t lineNumber = 0;
+            static char program[] = "";
+
+            for (;;)
+            {
+                Block* block = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(shared->mMutex);
+                    shared->mCondition.wait(lock, [&shared]() { return shared->mStop || !shared->mFree.empty(); });
+                    if (shared->mStop)
+                        return;
+                    block = shared->mFree.front();
+                    shared->mFree.pop_front();
+                }
+
+                std::vector<char>& data = block->mData;
+                data.resize(std::max(blockSize, carry.size() * 2) + 1);
+                std::memcpy(data.data(), carry.data(), carry.size());
+                size_t length = carry.size() + std::fread(data.data() + carry.size(), 1, data.size() - carry.size() - 1, input);
+                block->mLast = length < data.size() - 1;
+
+                size_t usable = length;
+                if (!block->mLast)
+                {
+                    const char* lastNewline = nullptr;
+                    for (size_t i = length; i > 0 && lastNewline == nullptr; --i)
+                        if (data[i - 1] == '\n')
+                            lastNewline = &data[i - 1];
+                    usable = lastNewline != nullptr ? static_cast<size_t>(lastNewline - data.data()) + 1 : 0;
+                }
+                carry.assign(data.data() + usable, length - usable);
+
+                block->mTokens.clear();
+                block->mLines.clear();
+                char* begin = data.data();
+                char* end = data.data() + usable;
+                while (begin < end)
+                {
+                    char* newline = static_cast<char*>(std::memchr(begin, '\n', end - begin));
+                    char* lineEnd = newline != nullptr ? newline : end;
+
+                    Line line;
+                    line.mNumber = ++lineNumber;
+                    line.mFirstToken = block->mTokens.size();
+                    block->mTokens.push_back(program);
+                    line.mValid = ResponseFile::tokenize(begin, lineEnd, block->mTokens);
+                    line.mTokenCount = block->mTokens.size() - line.mFirstToken;
+
+                    if (line.mTokenCount > 1 || !line.mValid)
+                        block->mLines.push_back(line);
+                    else
+                        block->mTokens.pop_back();
+
+                    begin = lineEnd + 1;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(shared->mMutex);
+                    if (shared->mStop)
+                        return;
+                    shared->mReady.push_back(block);
+                }
+                shared->mCondition.notify_all();
+
+                if (block->mLast)
+                    return;
+            }
+        }
+    };
+
+    template <size_t MaxOptions, size_t MaxSpellings = 2, size_t MaxArgs = 2, size_t ValueBytes = 256>
+    class FixedParser
+    {
+    public:
+        typedef Parser::ParsingResult ParsingResult;
+
+        class Option
+        {
+        public:
+            struct Argument
+            {
+                const char* mId;
+                const char* mDesc;
             };
 
-            Option(
-                const std::list<std::string>& opts,
-                const std::string& description = "",
-                bool mandatory = true, 
-                const std::vector<Argument>& args = {},
-                std::function<bool(Option&)> validator = nullptr
-            )
-                : mOpts(opts)
-                , mDescription(description)
-                , mMandatory(mandatory)
-                , mArgsRef(args)
-                , mProvided(false)
-                , mValidator(validator)
+            typedef bool (*Validator)(Option& option, void* context);
+
+            const char* value(const char* id) const
             {
-                for(size_t i = 0; i < mArgsRef.size(); ++i)
-                    mArgsMap.insert(std::make_pair(mArgsRef[i].mId, i));
+                for (size_t i = 0; i < mArgCount; ++i)
+                    if (std::strcmp(mArgs[i].mId, id) == 0)
+                        return mValues[i];
+                return nullptr;
             }
 
-            const std::string& value(const std::string& id) const
+            bool provided() const
             {
-                if (mArgsMap.find(id) == mArgsMap.end())
-                    throw ParsingException("Invalid Argument");
-                return mArgsRef[mArgsMap.at(id)].mValue;
+                return mProvided;
             }
 
         private:
-            std::list<std::string> mOpts;
-            std::string mDescription;
+            const char* mOpts[MaxSpellings];
+            size_t mOptCount;
+            const char* mDescription;
             bool mMandatory;
-            std::vector<Argument> mArgsRef;
-            std::map<std::string, size_t> mArgsMap;
+            Argument mArgs[MaxArgs];
+            const char* mValues[MaxArgs];
+            size_t mArgCount;
             bool mProvided;
-            std::function<bool(Option&)> mValidator;
-
-            friend class Parser;
+            Validator mValidator;
+            void* mContext;
 
-            bool checkMandatory()
-            {
-                return !mMandatory || mProvided;
-            }
+            friend class FixedParser;
         };
-        
-        Parser(const std::string& program = "", const std::string& version = "", const std::string& description = "")
+
+        FixedParser(const char* program = "", const char* version = "", const char* description = "")
             : mProgram(program)
             , mVersion(version)
             , mDescription(description)
+            , mOptionCount(0)
+            , mValueUsed(0)
         {
         }
 
-        void addOptions(const std::list<Option>& options)
+        bool addOption(
+            std::initializer_list<const char*> opts,
+            const char* description = "",
+            bool mandatory = true,
+            std::initializer_list<typename Option::Argument> args = {},
+            typename Option::Validator validator = nullptr,
+            void* context = nullptr
+        )
         {
-            for (auto option : options)
-                addOption(option);
-        }
+            if (mOptionCount >= MaxOptions || opts.size() == 0 || opts.size() > MaxSpellings || args.size() > MaxArgs)
+                return false;
 
-        void addOption(Option& option)
-        {
-            mOptionRefs.push_back(option);
-            Option& ref = mOptionRefs.back();
-            for (auto opt : ref.mOpts)
-                mOptionsMap[opt] = &ref;
+            Option& opt = mOptions[mOptionCount++];
+            opt.mOptCount = 0;
+            for (auto spelling : opts)
+                opt.mOpts[opt.mOptCount++] = spelling;
+            opt.mDescription = description;
+            opt.mMandatory = mandatory;
+            opt.mArgCount = 0;
+            for (auto& arg : args)
+            {
+                opt.mValues[opt.mArgCount] = "";
+                opt.mArgs[opt.mArgCount++] = arg;
+            }
+            opt.mProvided = false;
+            opt.mValidator = validator;
+            opt.mContext = context;
+            return true;
         }
 
-        std::string composeHelpString() const
+        void printHelp(std::ostream& out = std::cout) const
         {
-            std::stringstream ss;
-            
-            if (mProgram.length() > 0)
+            const size_t optWidth = CLI_MAX_LINE_WIDTH * 30 / 100;
+            const size_t descWidth = CLI_MAX_LINE_WIDTH * 70 / 100;
+
+            if (*mProgram)
             {
-                ss << separtor() << std::endl;
-                ss << std::left << std::setw(CLI_MAX_LINE_WIDTH * 75 / 100) << mProgram;
-                ss << std::right << std::setw(CLI_MAX_LINE_WIDTH * 25 / 100) << mVersion;
-                ss << std::endl << separtor() << std::endl;
+                separator(out);
+                out << std::left << std::setw(CLI_MAX_LINE_WIDTH * 75 / 100) << mProgram;
+                out << std::right << std::setw(CLI_MAX_LINE_WIDTH * 25 / 100) << mVersion;
+                out << std::endl;
+                separator(out);
             }
-            
-            if(mDescription.length() > 0)
-                ss << splitWords(mDescription) << std::endl << separtor() << std::endl;
 
-            ss << std::endl;
+            if (*mDescription)
+            {
+                splitWords(out, mDescription, CLI_MAX_LINE_WIDTH, 0);
+                out << std::endl;
+                separator(out);
+            }
 
-            for (auto opt : mOptionRefs)
+            out << std::endl;
+
+            for (size_t i = 0; i < mOptionCount; ++i)
             {
-                std::string optsStr = ((opt.mMandatory) ? "*" : "") + opt.mOpts.front();
-                for (auto it = ++opt.mOpts.begin(); it != opt.mOpts.end(); ++it)
-                    optsStr += ", " + *it;
+                const Option& opt = mOptions[i];
+                size_t written = 0;
 
-                if (opt.mArgsRef.size() > 0)
-                    optsStr += " {args...}";
+                if (opt.mMandatory)
+                    written += write(out, "*");
+                written += write(out, opt.mOpts[0]);
+                for (size_t j = 1; j < opt.mOptCount; ++j)
+                {
+                    written += write(out, ", ");
+                    written += write(out, opt.mOpts[j]);
+                }
+                if (opt.mArgCount > 0)
+                    written += write(out, " {args...}");
 
-                ss << std::left << std::setw(CLI_MAX_LINE_WIDTH * 30 / 100) << optsStr;
-                ss << std::left << splitWords(opt.mDescription, CLI_MAX_LINE_WIDTH * 70 / 100, std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' '));
-                ss << std::endl;
+                pad(out, written < optWidth ? optWidth - written : 0);
+                splitWords(out, opt.mDescription, descWidth, optWidth);
+                out << std::endl;
 
-                if (opt.mArgsRef.size() > 0)
+                if (opt.mArgCount > 0)
                 {
-                    ss << std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' ') << "Arguments: " << std::endl;
+                    pad(out, optWidth);
+                    out << "Arguments: " << std::endl;
 
-                    for (auto arg : opt.mArgsRef)
+                    for (size_t j = 0; j < opt.mArgCount; ++j)
                     {
-                        std::string argStr = "{" + arg.mId + "} => ";
-                        ss << std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' ') << argStr;
-                        ss << splitWords(arg.mDesc, CLI_MAX_LINE_WIDTH * 70 / 100, std::string(CLI_MAX_LINE_WIDTH * 30 / 100, ' '));
-                        ss << std::endl;
+                        pad(out, optWidth);
+                        out << "{" << opt.mArgs[j].mId << "} => ";
+                        splitWords(out, opt.mArgs[j].mDesc, descWidth, optWidth);
+                        out << std::endl;
                     }
                 }
             }
-
-            return ss.str();
-        }
-
-        std::string separtor() const
-        {
-            return std::string(CLI_MAX_LINE_WIDTH, '-');
         }
 
-        std::string splitWords(const std::string& value, size_t width = CLI_MAX_LINE_WIDTH, const std::string& padStr = "") const
+        ParsingResult parse(int argc, char* argv[])
         {
-            std::stringstream ss;
-            std::string copy = value;
-            std::string padStrInUse;
-
-            while (copy.size() > width)
+            mValueUsed = 0;
+            for (size_t i = 0; i < mOptionCount; ++i)
             {
-                std::string block = copy.substr(0, width);
-                size_t index = block.find_last_of(' ');
-                
-                if (index != std::string::npos)
-                {
-                    ss << padStrInUse << block.substr(0, index) << std::endl;
-                    copy = copy.substr(index + 1);
-                }
-                else
-                {
-                    ss << padStrInUse << block << std::endl;
-                    copy = copy.substr(width);
-                }
-
-                padStrInUse = padStr;
+                mOptions[i].mProvided = false;
+                for (size_t j = 0; j < mOptions[i].mArgCount; ++j)
+                    mOptions[i].mValues[j] = "";
             }
-            
-            ss << padStrInUse << copy;
-            return ss.str();
-        }
 
-        ParsingResult parse(int argc, char* argv[])
-        {
             for (int i = 1; i < argc; ++i)
             {
-                std::string arg = argv[i];
-                if (arg == "--help" || arg == "-h" || arg == "/?")
+                const char* arg = argv[i];
+                if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "/?") == 0)
                 {
-                    std::cout << composeHelpString() << std::endl;
-                    return PARSED_HELP;
+                    printHelp();
+                    std::cout << std::endl;
+                    return Parser::PARSED_HELP;
                 }
 
-                if (mOptionsMap.find(arg) == mOptionsMap.end())
+                Option* opt = find(arg);
+                if (opt == nullptr)
                 {
                     std::cerr << "Invalid argument {'" << arg << "'}. Please use --help for more information." << std::endl;
-                    return PARSED_FAILED;
+                    return Parser::PARSED_FAILED;
                 }
 
-                auto& opt = mOptionsMap[arg];
-                
-                for(auto& innerArg : opt->mArgsRef)
+                for (size_t j = 0; j < opt->mArgCount; ++j)
                 {
                     if (i + 1 >= argc)
                     {
-                        std::cerr << "Missing argument {'" << innerArg.mId << "'} for parameter '" << arg << "'. Please use --help for more information." << std::endl;
-                        return PARSED_FAILED;
+                        std::cerr << "Missing argument {'" << opt->mArgs[j].mId << "'} for parameter '" << arg << "'. Please use --help for more information." << std::endl;
+                        return Parser::PARSED_FAILED;
+                    }
+
+                    const char* subArg = argv[++i];
+                    size_t length = std::strlen(subArg) + 1;
+                    if (length > ValueBytes - mValueUsed)
+                    {
+                        std::cerr << "Argument {'" << opt->mArgs[j].mId << "'} for parameter '" << arg << "' exceeds the value storage." << std::endl;
+                        return Parser::PARSED_FAILED;
                     }
-                    std::string subArg = argv[++i];
-                    innerArg.mValue = subArg;
+
+                    std::memcpy(mValueBuffer + mValueUsed, subArg, length);
+                    opt->mValues[j] = mValueBuffer + mValueUsed;
+                    mValueUsed += length;
                 }
 
-                if (opt->mValidator != nullptr && !opt->mValidator(*opt))
-                    return PARSED_FAILED_VALIDATOR;
+                if (opt->mValidator != nullptr && !opt->mValidator(*opt, opt->mContext))
+                    return Parser::PARSED_FAILED_VALIDATOR;
 
                 opt->mProvided = true;
             }
 
-            for (auto& opt : mOptionRefs)
+            for (size_t i = 0; i < mOptionCount; ++i)
             {
-                if (!opt.checkMandatory())
+                if (mOptions[i].mMandatory && !mOptions[i].mProvided)
                 {
-                    std::cerr << "Mandatory parameter {'" << opt.mOpts.front() << "'} not provided. Please use --help for more information." << std::endl;
-                    return PARSED_FAILED;
+                    std::cerr << "Mandatory parameter {'" << mOptions[i].mOpts[0] << "'} not provided. Please use --help for more information." << std::endl;
+                    return Parser::PARSED_FAILED;
                 }
             }
 
-            return PARSED_OK;
+            return Parser::PARSED_OK;
         }
 
-        const Option& operator () (const std::string& opt) const
+        const Option* operator () (const char* opt) const
         {
-            if (mOptionsMap.find(opt) == mOptionsMap.end())
-                throw ParsingException("Option Not Found!");
-            return *mOptionsMap.at(opt);
+            for (size_t i = 0; i < mOptionCount; ++i)
+                for (size_t j = 0; j < mOptions[i].mOptCount; ++j)
+                    if (std::strcmp(mOptions[i].mOpts[j], opt) == 0)
+                        return &mOptions[i];
+            return nullptr;
         }
 
     private:
-        std::string mProgram;
-        std::string mVersion;
-        std::string mDescription;
-        std::list<Option> mOptionRefs;
-        std::map<std::string, Option*> mOptionsMap;
+        const char* mProgram;
+        const char* mVersion;
+        const char* mDescription;
+        Option mOptions[MaxOptions];
+        size_t mOptionCount;
+        char mValueBuffer[ValueBytes];
+        size_t mValueUsed;
+
+        Option* find(const char* opt)
+        {
+            return const_cast<Option*>((*this)(opt));
+        }
+
+        static size_t write(std::ostream& out, const char* str)
+        {
+            size_t length = std::strlen(str);
+            out.write(str, length);
+            return length;
+        }
+
+        static void pad(std::ostream& out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out.put(' ');
+        }
+
+        static void separator(std::ostream& out)
+        {
+            for (size_t i = 0; i < CLI_MAX_LINE_WIDTH; ++i)
+                out.put('-');
+            out << std::endl;
+        }
+
+        static void splitWords(std::ostream& out, const char* value, size_t width, size_t padCount)
+        {
+            size_t length = std::strlen(value);
+            bool first = true;
+
+            while (length > width)
+            {
+                size_t index = width;
+                while (index > 0 && value[index - 1] != ' ')
+                    --index;
+
+                if (!first)
+                    pad(out, padCount);
+
+                if (index > 0)
+                {
+                    out.write(value, index - 1);
+                    value += index;
+                    length -= index;
+                }
+                else
+                {
+                    out.write(value, width);
+                    value += width;
+                    length -= width;
+                }
+
+                out << std::endl;
+                first = false;
+            }
+
+            if (!first)
+                pad(out, padCount);
+            out.write(value, length);
+        }
     };
 }
 
+#if defined(__GNUC__) && defined(__ELF__)
+#define CLI_HAS_OPTION_REGISTRY 1
+
+extern "C" const cli::RegisteredOption* const __start_cli_registry[] __attribute__((weak));
+extern "C" const cli::RegisteredOption* const __stop_cli_registry[] __attribute__((weak));
+
+inline cli::Registry::Iterator cli::Registry::begin()
+{
+    return __start_cli_registry;
+}
+
+inline cli::Registry::Iterator cli::Registry::end()
+{
+    return __stop_cli_registry;
+}
+
+#define CLI_REGISTRY_ENTRY_(name) \
+    static const ::cli::RegisteredOption* const cli_registry_entry_##name __attribute__((section("cli_registry"), used))
+
+#elif defined(_MSC_VER)
+#define CLI_HAS_OPTION_REGISTRY 1
+
+#pragma section("cli_reg$a", read)
+#pragma section("cli_reg$m", read)
+#pragma section("cli_reg$z", read)
+
+extern "C" __declspec(allocate("cli_reg$a")) __declspec(selectany) const cli::RegisteredOption* const cli_registry_begin = nullptr;
+extern "C" __declspec(allocate("cli_reg$z")) __declspec(selectany) const cli::RegisteredOption* const cli_registry_end = nullptr;
+
+inline cli::Registry::Iterator cli::Registry::begin()
+{
+    return &cli_registry_begin + 1;
+}
+
+inline cli::Registry::Iterator cli::Registry::end()
+{
+    return &cli_registry_end;
+}
+
+#if defined(_M_IX86)
+#define CLI_REGISTRY_SYMBOL_(name) "_cli_registry_entry_" #name
+#else
+#define CLI_REGISTRY_SYMBOL_(name) "cli_registry_entry_" #name
+#endif
+
+#define CLI_REGISTRY_ENTRY_(name) \
+    __pragma(comment(linker, "/include:" CLI_REGISTRY_SYMBOL_(name))) \
+    extern "C" __declspec(allocate("cli_reg$m")) const ::cli::RegisteredOption* const cli_registry_entry_##name; \
+    extern "C" __declspec(allocate("cli_reg$m")) const ::cli::RegisteredOption* const cli_registry_entry_##name
+
+#else
+#define CLI_HAS_OPTION_REGISTRY 0
+
+inline cli::Registry::Iterator cli::Registry::begin()
+{
+    return nullptr;
+}
+
+inline cli::Registry::Iterator cli::Registry::end()
+{
+    return nullptr;
+}
+#endif
+
+#if CLI_HAS_OPTION_REGISTRY
+#define CLI_DEFINE_OPTION_(type, kind, name, spelling, defaultValue, description) \
+    namespace cli_flags { type name = defaultValue; } \
+    static const ::cli::RegisteredOption cli_registered_##name = { spelling, description, ::cli::RegisteredOption::kind, &cli_flags::name }; \
+    CLI_REGISTRY_ENTRY_(name) = &cli_registered_##name
+
+#define CLI_DEFINE_BOOL(name, spelling, description) CLI_DEFINE_OPTION_(bool, KIND_BOOL, name, spelling, false, description)
+#define CLI_DEFINE_INT(name, spelling, defaultValue, description) CLI_DEFINE_OPTION_(long long, KIND_INT, name, spelling, defaultValue, description)
+#define CLI_DEFINE_DOUBLE(name, spelling, defaultValue, description) CLI_DEFINE_OPTION_(double, KIND_DOUBLE, name, spelling, defaultValue, description)
+#define CLI_DEFINE_STRING(name, spelling, defaultValue, description) CLI_DEFINE_OPTION_(const char*, KIND_STRING, name, spelling, defaultValue, description)
+
+#define CLI_DECLARE_BOOL(name) namespace cli_flags { extern bool name; }
+#define CLI_DECLARE_INT(name) namespace cli_flags { extern long long name; }
+#define CLI_DECLARE_DOUBLE(name) namespace cli_flags { extern double name; }
+#define CLI_DECLARE_STRING(name) namespace cli_flags { extern const char* name; }
+#endif
+
 #endif
@@ -0,0 +1,34 @@
+/* A C getopt_long loop built against cli_getopt.h in replace mode, with the
+   system header included first. */
+#include <getopt.h>
+#include <string.h>
+
+#define CLI_GETOPT_REPLACE
+#include "cli_getopt.h"
+
+int run_c_getopt(int argc, char** argv, char* name, size_t size)
+{
+    static const struct option longopts[] = {
+        { "name", required_argument, 0, 'n' },
+        { "verbose", no_argument, 0, 'v' },
+        { 0, 0, 0, 0 },
+    };
+    int verbose = 0;
+    int c;
+
+    optind = 1;
+    opterr = 0;
+    while ((c = getopt_long(argc, argv, "n:v", longopts, 0)) != -1)
+    {
+        if (c == 'n')
+        {
+            strncpy(name, optarg, size - 1);
+            name[size - 1] = '\0';
+        }
+        else if (c == 'v')
+            verbose = 1;
+        else
+            return -1;
+    }
+    return verbose * 100 + optind;
+}
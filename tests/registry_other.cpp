@@ -0,0 +1,7 @@
+// Options registered from a second translation unit.
+#include "cli_parser.h"
+
+#if CLI_HAS_OPTION_REGISTRY
+CLI_DEFINE_STRING(other_mode, "--other-mode", "fast", "A string registered elsewhere.");
+CLI_DEFINE_INT(other_level, "--other-level", 3, "An integer registered elsewhere.");
+#endif
@@ -0,0 +1,57 @@
+#!/bin/sh
+# Builds and runs every test program under ASan/UBSan, and the threaded ones
+# (listed in TSAN_TESTS) under TSan as well. Tests in SIMD_TESTS are also
+# built scalar-only (CLI_NO_SIMD) and, on x86, with SSSE3, so every code path
+# is checked against the same reference. A test that needs a newer standard
+# names it on a "// std: c++20" line, and one made of several files lists the
+# others on a "// sources: a.cpp b.c" line; C files are built with $CC.
+# Usage: tests/run.sh [compiler]
+set -e
+cd "$(dirname "$0")"
+CXX=${1:-${CXX:-g++}}
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}/cli_parser_tests
+BASE_FLAGS="-g -O1 -Wall -Wextra -pthread -I.."
+TSAN_TESTS="test_accessors test_batch test_command test_frozen test_index test_parallel"
+SIMD_TESTS="test_value_checks test_decode test_query test_typed"
+case $(uname -m) in
+x86_64|i?86|amd64) SSSE3="-mssse3" ;;
+*) SSSE3="" ;;
+esac
+mkdir -p "$OUT"
+
+failed=0
+for source in test_*.cpp; do
+    name=${source%.cpp}
+    std=$(sed -n 's,^// std: ,,p' "$source")
+    FLAGS="-std=${std:-c++11} $BASE_FLAGS"
+    sources=""
+    for extra in $(sed -n 's,^// sources: ,,p' "$source"); do
+        case $extra in
+        *.c)
+            $CC -g -O1 -Wall -Wextra -Werror -I.. -fsanitize=address,undefined -c "$extra" -o "$OUT/${extra%.c}.o" || failed=1
+            sources="$sources $OUT/${extra%.c}.o"
+            ;;
+        *) sources="$sources $extra" ;;
+        esac
+    done
+    $CXX $FLAGS -fsanitize=address,undefined -fno-sanitize-recover=undefined "$source" $sources -o "$OUT/$name" || { failed=1; continue; }
+    "$OUT/$name" > "$OUT/$name.log" 2>&1 && echo "PASS $name" || { echo "FAIL $name"; cat "$OUT/$name.log"; failed=1; }
+
+    case " $TSAN_TESTS " in
+    *" $name "*)
+        $CXX $FLAGS -fsanitize=thread "$source" $sources -o "$OUT/$name.tsan" || { failed=1; continue; }
+        "$OUT/$name.tsan" > "$OUT/$name.tsan.log" 2>&1 && echo "PASS $name (tsan)" || { echo "FAIL $name (tsan)"; cat "$OUT/$name.tsan.log"; failed=1; }
+        ;;
+    esac
+
+    case " $SIMD_TESTS " in
+    *" $name "*)
+        for variant in "-DCLI_NO_SIMD" $SSSE3; do
+            $CXX $FLAGS $variant -fsanitize=address,undefined -fno-sanitize-recover=undefined "$source" $sources -o "$OUT/$name$variant" || { failed=1; continue; }
+            "$OUT/$name$variant" > "$OUT/$name$variant.log" 2>&1 && echo "PASS $name ($variant)" || { echo "FAIL $name ($variant)"; cat "$OUT/$name$variant.log"; failed=1; }
+        done
+        ;;
+    esac
+done
+exit $failed
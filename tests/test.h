@@ -0,0 +1,29 @@
+#ifndef CLI_TEST_H
+#define CLI_TEST_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the standalone test programs: each failing CHECK prints
+// its location and the program exits non-zero from TEST_END.
+static int cli_test_failures = 0;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++cli_test_failures; \
+        } \
+    } while (0)
+
+#define TEST_END() \
+    do \
+    { \
+        if (cli_test_failures != 0) \
+            std::fprintf(stderr, "%d check(s) failed\n", cli_test_failures); \
+        return cli_test_failures != 0 ? EXIT_FAILURE : EXIT_SUCCESS; \
+    } while (0)
+
+#endif
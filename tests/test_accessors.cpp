@@ -0,0 +1,65 @@
+// std: c++20
+#include "cli_parser.h"
+#include "test.h"
+
+#include <thread>
+
+template <typename Read>
+static bool throwsNotFound(Read read)
+{
+    try
+    {
+        read();
+    }
+    catch (const cli::ParsingException& e)
+    {
+        return std::string(e.what()) == "Option Not Found!";
+    }
+    return false;
+}
+
+int main()
+{
+#if CLI_HAS_FIXED_STRING
+    const char* argv[] = { "test", "--name", "alice", "-v" };
+    cli::Parser parser("test");
+    parser.addOptions({
+        {{"--name"}, "Name.", true, {{"value", "The name."}}},
+        {{"-v"}, "Verbose.", false},
+    });
+    CHECK(parser.parse(4, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+
+    // Concurrent first reads race to fill the same cache slots (TSan checks them).
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches(0);
+    const cli::Parser::Option* option = &parser("--name");
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&parser, &mismatches, option]() {
+            for (int n = 0; n < 1000; ++n)
+            {
+                if (parser.get<"--name", "value">() != "alice" || &parser.get<"--name">() != option)
+                    ++mismatches;
+            }
+        });
+    }
+    for (auto& reader : readers)
+        reader.join();
+    CHECK(mismatches == 0);
+
+    // A moved-from parser owns no options, so its cached slots must not
+    // point into the ones it gave away.
+    cli::Parser moved(std::move(parser));
+    CHECK(&moved.get<"--name">() == &moved("--name"));
+    CHECK((moved.get<"--name", "value">() == "alice"));
+    CHECK(throwsNotFound([&parser]() { parser.get<"--name">(); }));
+    CHECK(throwsNotFound([&parser]() { parser.get<"--name", "value">(); }));
+
+    cli::Parser assigned;
+    assigned = std::move(moved);
+    CHECK(&assigned.get<"--name">() == &assigned("--name"));
+    CHECK(throwsNotFound([&moved]() { moved.get<"--name">(); }));
+    CHECK(throwsNotFound([&moved]() { moved.get<"--name", "value">(); }));
+#endif
+    TEST_END();
+}
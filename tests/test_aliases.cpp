@@ -0,0 +1,47 @@
+#include "cli_parser.h"
+#include "test.h"
+
+static size_t occurrences(const std::string& text, const std::string& word)
+{
+    size_t count = 0;
+    for (size_t at = text.find(word); at != std::string::npos; at = text.find(word, at + 1))
+        ++count;
+    return count;
+}
+
+int main()
+{
+    std::ostringstream output;
+    std::ostringstream errors;
+    cli::Parser parser("test");
+    parser.setStreams(output, errors);
+    parser.addOptions({
+        {{"--new-name"}, "Name.", false, {{"value", "The name."}}},
+        {{"--verbose"}, "Verbose.", false, {}},
+    });
+    parser.addDeprecatedAlias("--old-name", "--new-name");
+    parser.addDeprecatedAlias("--loud", "--verbose");
+
+    // The alias fills the canonical option.
+    const char* argv[] = { "test", "--old-name", "alice", "--old-name", "bob", "--loud" };
+    CHECK(parser.parse(6, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--new-name").value("value") == "bob");
+    CHECK(occurrences(errors.str(), "'--old-name' is deprecated, please use '--new-name'") == 1);
+    CHECK(occurrences(errors.str(), "'--loud' is deprecated, please use '--verbose'") == 1);
+
+    // Each alias warns once per parser, however often it is used.
+    parser.reset();
+    CHECK(parser.parse(6, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    CHECK(parser.parseQuery("old-name=carol") == cli::Parser::PARSED_OK);
+    CHECK(parser("--new-name").value("value") == "carol");
+    CHECK(occurrences(errors.str(), "deprecated") == 2);
+    CHECK(output.str().empty());
+
+    // Help lists only the canonical spellings.
+    const char* help[] = { "test", "--help" };
+    CHECK(parser.parse(2, const_cast<char**>(help)) == cli::Parser::PARSED_HELP);
+    CHECK(output.str().find("--new-name") != std::string::npos);
+    CHECK(output.str().find("--old-name") == std::string::npos);
+    CHECK(output.str().find("--loud") == std::string::npos);
+    TEST_END();
+}
@@ -0,0 +1,89 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <stdexcept>
+
+static std::FILE* input(const char* text)
+{
+    std::FILE* file = std::tmpfile();
+    std::fputs(text, file);
+    std::rewind(file);
+    return file;
+}
+
+static void addOptions(cli::Parser& parser)
+{
+    parser.addOptions({
+        {{"--name"}, "Name.", true, {{"value", "The name."}}},
+    });
+}
+
+int main()
+{
+    std::FILE* sink = std::tmpfile();
+
+    // Without a handler, every line that parses counts as a success.
+    {
+        std::ostringstream output;
+        std::ostringstream errors;
+        cli::Parser parser("test");
+        addOptions(parser);
+        parser.setStreams(output, errors);
+
+        std::FILE* file = input("--name a\n--name b\n--bogus\n");
+        cli::BatchDriver driver(parser, nullptr);
+        CHECK(driver.run(file, sink, sink) == 1);
+        std::fclose(file);
+
+        // The caller's streams are restored afterwards.
+        cli::Parser::ParsingResult result = parser.parse(1, nullptr);
+        CHECK(result == cli::Parser::PARSED_FAILED);
+        CHECK(errors.str().find("Mandatory parameter") != std::string::npos);
+    }
+
+    // A handler returning false counts the line as failed.
+    {
+        cli::Parser parser("test");
+        addOptions(parser);
+        std::FILE* file = input("--name a\n--name b\n");
+        cli::BatchDriver driver(parser, [](cli::Parser& p, cli::BatchSink&) { return p("--name").value("value") == "a"; });
+        CHECK(driver.run(file, sink, sink) == 1);
+        std::fclose(file);
+    }
+
+#if CLI_HAS_MMAP
+    // A throwing handler returns promptly even though the reader is still
+    // blocked on input that has not reached EOF.
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+        const char lines[] = "--name a\n--name b\n--name c\n";
+        CHECK(::write(fds[1], lines, sizeof(lines) - 1) == static_cast<ssize_t>(sizeof(lines) - 1));
+        std::FILE* file = ::fdopen(fds[0], "r");
+
+        std::ostringstream errors;
+        cli::Parser parser("test");
+        addOptions(parser);
+        parser.setStreams(errors, errors);
+        cli::BatchDriver driver(parser, [](cli::Parser&, cli::BatchSink&) -> bool { throw std::runtime_error("handler"); }, 16);
+
+        bool thrown = false;
+        try
+        {
+            driver.run(file, sink, sink);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(&parser.errorStream() == &errors);
+
+        // Unblock the detached reader so it can exit before the process does.
+        ::close(fds[1]);
+    }
+#endif
+
+    std::fclose(sink);
+    TEST_END();
+}
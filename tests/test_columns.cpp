@@ -0,0 +1,76 @@
+#include "cli_parser.h"
+#include "test.h"
+
+static std::string entry(const cli::ColumnCollector::Column& column, int32_t index)
+{
+    const auto& offsets = column.mDictionaryOffsets;
+    return std::string(column.mDictionaryData.data() + offsets[index], column.mDictionaryData.data() + offsets[index + 1]);
+}
+
+int main()
+{
+    std::ostringstream sink;
+    cli::Parser parser;
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--queue"}, "Queue.", false, {{"name", "The queue."}}},
+        {{"--retries"}, "Retries.", false, {{"count", "The count."}}},
+    });
+
+    cli::ColumnCollector collector(parser);
+    collector.setType("--retries", "count", cli::ColumnCollector::COLUMN_INT64);
+
+    // Rows cycle through 1000 queue names, with every seventh row unset.
+    const int rows = 20000;
+    for (int row = 0; row < rows; ++row)
+    {
+        std::string queue = "queue-" + std::to_string(row % 1000);
+        std::string retries = std::to_string(row % 5);
+        const char* argv[] = { "test", "--queue", queue.c_str(), "--retries", retries.c_str() };
+        parser.reset();
+        CHECK(parser.parse(row % 7 == 0 ? 1 : 5, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        collector.append(parser);
+    }
+    CHECK(collector.rows() == static_cast<size_t>(rows));
+
+    const auto& queues = collector.column("--queue", "name");
+    CHECK(queues.mDictionary.size() == 1000);
+    CHECK(queues.mDictionaryOffsets.size() == 1001);
+    CHECK(queues.mIndices.size() == static_cast<size_t>(rows));
+
+    int wrong = 0;
+    size_t nulls = 0;
+    for (int row = 0; row < rows; ++row)
+    {
+        bool valid = (queues.mValidity[row / 8] >> (row % 8) & 1) != 0;
+        nulls += !valid;
+        if (valid != (row % 7 != 0) || (valid && entry(queues, queues.mIndices[row]) != "queue-" + std::to_string(row % 1000)))
+            ++wrong;
+    }
+    CHECK(wrong == 0);
+    CHECK(nulls == queues.mNullCount);
+
+    const auto& retries = collector.column("--retries", "count");
+    CHECK(retries.mInt64.size() == static_cast<size_t>(rows));
+    CHECK(retries.mInt64[13] == 3);
+
+    // Integers are decimal, as for registered options: "010" is ten and
+    // "0x10" does not parse.
+    {
+        cli::ColumnCollector numbers(parser);
+        numbers.setType("--retries", "count", cli::ColumnCollector::COLUMN_INT64);
+        for (const char* value : { "010", "0x10" })
+        {
+            const char* argv[] = { "test", "--retries", value };
+            parser.reset();
+            CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+            numbers.append(parser);
+        }
+        const auto& counts = numbers.column("--retries", "count");
+        CHECK(counts.mInt64[0] == 10);
+        CHECK((counts.mValidity[0] & 1) != 0);
+        CHECK((counts.mValidity[0] & 2) == 0);
+        CHECK(counts.mNullCount == 1);
+    }
+    TEST_END();
+}
@@ -0,0 +1,137 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    std::ostringstream sink;
+
+    // Schemas whose short spellings once cancelled out of the fingerprint;
+    // a match would let one schema's command dispatch into the other's.
+    cli::Parser user;
+    user.setStreams(sink, sink);
+    user.addOptions({
+        {{"--user"}, "User.", false, {{"v", "The user."}}},
+        {{"-b"}, "Batch.", false, {}},
+    });
+    cli::Parser remove;
+    remove.setStreams(sink, sink);
+    remove.addOptions({
+        {{"--delete"}, "Delete.", false, {{"path", "The path."}}},
+        {{"--force"}, "Force.", false, {}},
+        {{"-b"}, "Batch.", false, {}},
+    });
+    CHECK(user.fingerprint() != remove.fingerprint());
+
+    // Argument checks and ids are part of the schema.
+    {
+        cli::Parser plain;
+        plain.addOptions({{{"--key"}, "Key.", false, {{"value", "The key."}}}});
+        cli::Parser hex;
+        hex.addOptions({{{"--key"}, "Key.", false, {{"value", "The key.", cli::Parser::DECODE_HEX}}}});
+        cli::Parser renamed;
+        renamed.addOptions({{{"--key"}, "Key.", false, {{"data", "The key."}}}});
+        CHECK(plain.fingerprint() != hex.fingerprint());
+        CHECK(plain.fingerprint() != renamed.fingerprint());
+    }
+
+    // A child parser's schema is part of its parent's, including options the
+    // child gains after it was attached.
+    {
+        cli::Parser child("tool");
+        child.addOptions({{{"--a"}, "A.", false, {{"value", "The a."}}}});
+        cli::Parser parent("test");
+        parent.addOptions({{{"--exec"}, "Command.", false, {{"cmd", "The command.", child}}}});
+        cli::Parser plain("test");
+        plain.addOptions({{{"--exec"}, "Command.", false, {{"cmd", "The command."}}}});
+        CHECK(parent.fingerprint() != plain.fingerprint());
+
+        uint64_t before = parent.fingerprint();
+        CHECK(parent.fingerprint() == before);
+        child.addOptions({{{"--b"}, "B.", false, {}}});
+        CHECK(parent.fingerprint() != before);
+
+        cli::Parser twin("tool");
+        twin.addOptions({
+            {{"--a"}, "A.", false, {{"value", "The a."}}},
+            {{"--b"}, "B.", false, {}},
+        });
+        CHECK(twin.fingerprint() == child.fingerprint());
+        cli::Parser twinParent("test");
+        twinParent.addOptions({{{"--exec"}, "Command.", false, {{"cmd", "The command.", twin}}}});
+        CHECK(twinParent.fingerprint() == parent.fingerprint());
+
+        // Copies share the schema; a moved-from parser is empty again.
+        cli::Parser copy(parent);
+        CHECK(copy.fingerprint() == parent.fingerprint());
+        cli::Parser moved(std::move(copy));
+        CHECK(moved.fingerprint() == parent.fingerprint());
+        CHECK(copy.fingerprint() == cli::Parser("test").fingerprint());
+
+        // fingerprint() only reads, so concurrent first calls need no locking
+        // (TSan checks it).
+        cli::Parser fresh("test");
+        fresh.addOptions({{{"--exec"}, "Command.", false, {{"cmd", "The command.", twin}}}});
+        std::vector<std::thread> readers;
+        std::atomic<int> mismatches(0);
+        uint64_t expected = parent.fingerprint();
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&fresh, &mismatches, expected]() {
+                for (int n = 0; n < 1000; ++n)
+                {
+                    if (fresh.fingerprint() != expected)
+                        ++mismatches;
+                }
+            });
+        }
+        for (auto& reader : readers)
+            reader.join();
+        CHECK(mismatches == 0);
+    }
+
+    // A command for another schema falls back to text, by spelling.
+    {
+        const char* argv[] = { "test", "--user", "alice", "-b" };
+        CHECK(user.parse(4, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        char buffer[256];
+        size_t length = user.encodeCommand(buffer, sizeof(buffer));
+        CHECK(length <= sizeof(buffer));
+        CHECK(remove.parseCommand(buffer, length) != cli::Parser::PARSED_OK);
+        CHECK(remove("--delete").value("path").empty());
+    }
+
+    // The text fallback never expands response files, even when the parser
+    // expands them on the command line.
+    {
+        char path[] = "/tmp/cli_command_XXXXXX";
+        int descriptor = mkstemp(path);
+        CHECK(descriptor >= 0);
+        std::FILE* file = fdopen(descriptor, "w");
+        std::fputs("--delete secret-contents", file);
+        std::fclose(file);
+
+        std::string spelling = std::string("@") + path;
+        cli::Parser sender;
+        sender.setStreams(sink, sink);
+        sender.addOptions({{{spelling}, "Spelled like a response file.", false, {}}});
+        const char* argv[] = { "test", spelling.c_str() };
+        CHECK(sender.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        char buffer[256];
+        size_t length = sender.encodeCommand(buffer, sizeof(buffer));
+        CHECK(length <= sizeof(buffer));
+
+        std::ostringstream errors;
+        remove.reset();
+        remove.setStreams(errors, errors);
+        remove.setResponseFiles(true);
+        CHECK(remove.parseCommand(buffer, length) != cli::Parser::PARSED_OK);
+        CHECK(remove("--delete").value("path").empty());
+        CHECK(errors.str().find("secret-contents") == std::string::npos);
+        std::remove(path);
+    }
+    TEST_END();
+}
@@ -0,0 +1,124 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <cstring>
+#include <random>
+
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Plain one-character-at-a-time decoders with the rules the vectorized ones
+// must agree with. Return false for input the parser must reject.
+static bool referenceHex(const std::string& text, std::string& out)
+{
+    out.clear();
+    if (text.size() % 2 != 0)
+        return false;
+    for (size_t i = 0; i < text.size(); i += 2)
+    {
+        const char* high = std::strchr("0123456789abcdef", std::tolower(static_cast<unsigned char>(text[i])));
+        const char* low = std::strchr("0123456789abcdef", std::tolower(static_cast<unsigned char>(text[i + 1])));
+        if (text[i] == '\0' || text[i + 1] == '\0' || high == nullptr || low == nullptr)
+            return false;
+        out.push_back(static_cast<char>((high - "0123456789abcdef") << 4 | (low - "0123456789abcdef")));
+    }
+    return true;
+}
+
+static bool referenceBase64(const std::string& text, std::string& out)
+{
+    out.clear();
+    size_t length = text.size();
+    if (length % 4 == 0 && length > 0 && text[length - 1] == '=')
+        length -= text[length - 2] == '=' ? 2 : 1;
+    if (length % 4 == 1)
+        return false;
+
+    unsigned bits = 0;
+    int pending = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        const char* digit = text[i] != '\0' ? std::strchr(BASE64, text[i]) : nullptr;
+        if (digit == nullptr)
+            return false;
+        bits = bits << 6 | static_cast<unsigned>(digit - BASE64);
+        pending += 6;
+        if (pending >= 8)
+        {
+            pending -= 8;
+            out.push_back(static_cast<char>(bits >> pending));
+        }
+    }
+    return true;
+}
+
+static std::string encodeHex(const std::string& bytes, std::mt19937& random)
+{
+    const char* digits = random() % 2 ? "0123456789abcdef" : "0123456789ABCDEF";
+    std::string text;
+    for (unsigned char c : bytes)
+    {
+        text.push_back(digits[c >> 4]);
+        text.push_back(digits[c & 15]);
+    }
+    return text;
+}
+
+static std::string encodeBase64(const std::string& bytes, bool padded)
+{
+    std::string text;
+    for (size_t i = 0; i < bytes.size(); i += 3)
+    {
+        unsigned chunk = static_cast<unsigned char>(bytes[i]) << 16;
+        if (i + 1 < bytes.size())
+            chunk |= static_cast<unsigned char>(bytes[i + 1]) << 8;
+        if (i + 2 < bytes.size())
+            chunk |= static_cast<unsigned char>(bytes[i + 2]);
+        size_t count = std::min<size_t>(bytes.size() - i, 3) + 1;
+        for (size_t k = 0; k < 4; ++k)
+            text.push_back(k < count ? BASE64[chunk >> (18 - 6 * k) & 63] : '=');
+    }
+    if (!padded)
+        text.erase(text.find_last_not_of('=') + 1);
+    return text;
+}
+
+int main()
+{
+    std::ostringstream sink;
+    cli::Parser parser;
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--hex"}, "Hex value.", false, {{"value", "The value.", cli::Parser::DECODE_HEX}}},
+        {{"--base64"}, "Base64 value.", false, {{"value", "The value.", cli::Parser::DECODE_BASE64}}},
+    });
+
+    std::mt19937 random(89);
+    int mismatches = 0;
+    for (int n = 0; n < 40000; ++n)
+    {
+        // Lengths cover empty values, every tail length and several SIMD blocks.
+        std::string bytes(random() % 100, '\0');
+        for (auto& c : bytes)
+            c = static_cast<char>(random());
+
+        bool hex = n % 2 == 0;
+        std::string text = hex ? encodeHex(bytes, random) : encodeBase64(bytes, random() % 2 == 0);
+        if (random() % 3 == 0 && !text.empty())
+            text[random() % text.size()] = static_cast<char>(1 + random() % 255);
+
+        std::string expected;
+        bool valid = hex ? referenceHex(text, expected) : referenceBase64(text, expected);
+        const char* argv[] = { "test", hex ? "--hex" : "--base64", text.c_str() };
+        parser.reset();
+        bool accepted = parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK;
+
+        const cli::AlignedBuffer& decoded = parser(hex ? "--hex" : "--base64").bytes("value");
+        bool same = accepted == valid && (!accepted || (decoded.size() == expected.size() && std::memcmp(decoded.data(), expected.data(), expected.size()) == 0));
+        if (!same && ++mismatches <= 10)
+            std::fprintf(stderr, "mismatch decoding %s of %zu characters\n", hex ? "hex" : "base64", text.size());
+        if (accepted && reinterpret_cast<uintptr_t>(decoded.data()) % CLI_BYTES_ALIGNMENT != 0)
+            ++mismatches;
+    }
+    CHECK(mismatches == 0);
+    TEST_END();
+}
@@ -0,0 +1,92 @@
+#include "cli_parser.h"
+#include "test.h"
+
+static bool throws(const cli::Parser& parser, const char* opt, const char* id, const char* what)
+{
+    try
+    {
+        parser.expanded(opt, id);
+    }
+    catch (const cli::ParsingException& e)
+    {
+        return std::string(e.what()) == what;
+    }
+    return false;
+}
+
+int main()
+{
+    std::ostringstream output;
+    std::ostringstream errors;
+    cli::Parser parser("test");
+    parser.setStreams(output, errors);
+    parser.addOptions({
+        {{"--root"}, "Root.", false, {{"path", "The root."}}},
+        {{"--range"}, "Range.", false, {{"from", "Start."}, {"to", "End."}}},
+        {{"--log-dir"}, "Logs.", false, {{"path", "The log directory."}}},
+        {{"--price"}, "Price.", false, {{"text", "The price."}}},
+        {{"--open"}, "Unterminated.", false, {{"text", "Text."}}},
+        {{"--missing"}, "Unresolved.", false, {{"text", "Text."}}},
+        {{"--a"}, "Cycle.", false, {{"text", "Text."}}},
+        {{"--b"}, "Cycle.", false, {{"text", "Text."}}},
+    });
+    setenv("CLI_TEST_HOME", "/home/test", 1);
+    unsetenv("CLI_TEST_UNSET");
+
+    const char* argv[] = {
+        "test",
+        "--root", "/srv",
+        "--range", "3", "7",
+        "--log-dir", "${root}/${--range.to}/${CLI_TEST_HOME}",
+        "--price", "$$5 and $x and $",
+        "--open", "${root",
+        "--missing", "${CLI_TEST_UNSET}",
+        "--a", "${b}",
+        "--b", "<${--a}>",
+    };
+    CHECK(parser.parse(18, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+
+    // References resolve to options by bare or prefixed name, to a named
+    // argument after the dot, and otherwise to the environment.
+    CHECK(parser.expanded("--log-dir", "path") == "/srv/7//home/test");
+    CHECK(parser.expanded("--root", "path") == "/srv");
+
+    // "$$" is a literal dollar; a dollar not opening a reference is kept.
+    CHECK(parser.expanded("--price", "text") == "$5 and $x and $");
+
+    CHECK(throws(parser, "--open", "text", "Unterminated Reference"));
+    CHECK(throws(parser, "--missing", "text", "Unresolved Reference"));
+    CHECK(throws(parser, "--a", "text", "Cyclic Reference"));
+    CHECK(throws(parser, "--b", "text", "Cyclic Reference"));
+    // A failed expansion leaves nothing half-done behind.
+    CHECK(throws(parser, "--a", "text", "Cyclic Reference"));
+    CHECK(parser.expanded("--root", "path") == "/srv");
+
+    // Expansions are memoized: the same storage comes back until the next parse.
+    const std::string& first = parser.expanded("--log-dir", "path");
+    setenv("CLI_TEST_HOME", "/home/other", 1);
+    CHECK(&parser.expanded("--log-dir", "path") == &first);
+    CHECK(first == "/srv/7//home/test");
+
+    // reset() drops the memo, so new values and the environment are seen.
+    parser.reset();
+    const char* next[] = { "test", "--root", "/opt", "--log-dir", "${root}/${CLI_TEST_HOME}" };
+    CHECK(parser.parse(5, const_cast<char**>(next)) == cli::Parser::PARSED_OK);
+    CHECK(parser.expanded("--log-dir", "path") == "/opt//home/other");
+
+    // So does a parse on its own.
+    const char* again[] = { "test", "--root", "/var", "--log-dir", "${--root.path}" };
+    CHECK(parser.parse(5, const_cast<char**>(again)) == cli::Parser::PARSED_OK);
+    CHECK(parser.expanded("--log-dir", "path") == "/var");
+
+    // Options that were not provided fall through to the environment.
+    parser.reset();
+    const char* unset[] = { "test", "--log-dir", "${root}" };
+    CHECK(parser.parse(3, const_cast<char**>(unset)) == cli::Parser::PARSED_OK);
+    CHECK(throws(parser, "--log-dir", "path", "Unresolved Reference"));
+
+    CHECK(throws(parser, "--nope", "path", "Option Not Found!"));
+    CHECK(throws(parser, "--log-dir", "nope", "Invalid Argument"));
+    CHECK(output.str().empty());
+    TEST_END();
+}
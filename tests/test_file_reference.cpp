@@ -0,0 +1,99 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <fstream>
+#include <unistd.h>
+
+static std::string writeFile(const char* name, const char* text)
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/" + name;
+    std::ofstream(path.c_str()) << text;
+    return path;
+}
+
+static bool unopenable(const cli::Parser::Option& option, const char* id)
+{
+    try
+    {
+        option.content(id);
+    }
+    catch (const cli::ParsingException& e)
+    {
+        return std::string(e.what()).find("Unable to open file") == 0;
+    }
+    return false;
+}
+
+int main()
+{
+    std::string cert = writeFile("cli_parser_test.pem", "-----BEGIN CERT-----\n");
+    std::string other = writeFile("cli_parser_test_other.pem", "other");
+    std::string empty = writeFile("cli_parser_test_empty.pem", "");
+    std::string missing = cert + ".missing";
+    ::unlink(missing.c_str());
+    std::string certRef = "@" + cert;
+    std::string missingRef = "@" + missing;
+
+    std::ostringstream output;
+    std::ostringstream errors;
+    cli::Parser parser("test");
+    parser.setStreams(output, errors);
+    parser.setResponseFiles(true);
+    parser.addOptions({
+        {{"--cert"}, "Certificate.", false, {{"value", "The certificate.", cli::Parser::FILE_REFERENCE}}},
+        {{"--key"}, "Key.", false, {{"value", "The key.", cli::Parser::FILE_PATH}}},
+        {{"--note"}, "Note.", false, {{"value", "The note.", cli::Parser::FILE_REFERENCE}}},
+        {{"--plain"}, "Plain.", false, {{"value", "Plain text."}}},
+    });
+
+    // "@path" stands for the file; in argument position it is never a response file.
+    const char* argv[] = { "test", "--cert", certRef.c_str(), "--key", other.c_str(), "--note", "inline", "--plain", certRef.c_str() };
+    CHECK(parser.parse(9, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--cert").value("value") == certRef);
+    CHECK(parser("--cert").content("value").str() == "-----BEGIN CERT-----\n");
+    CHECK(parser("--key").content("value").str() == "other");
+    CHECK(parser("--note").content("value").str() == "inline");
+    CHECK(parser("--plain").content("value").str() == certRef);
+
+    // The mapping is made once and reused.
+    cli::ValueView first = parser("--cert").content("value");
+    CHECK(parser("--cert").content("value").data() == first.data());
+
+    // "@@" escapes a literal "@", leaving the rest of the value untouched.
+    const char* escaped[] = { "test", "--cert", "@@user", "--note", "@@" };
+    CHECK(parser.parse(5, const_cast<char**>(escaped)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--cert").content("value").str() == "@user");
+    CHECK(parser("--note").content("value").str() == "@");
+
+    // A lone "@" names the file "", which cannot be opened.
+    const char* lone[] = { "test", "--note", "@" };
+    CHECK(parser.parse(3, const_cast<char**>(lone)) == cli::Parser::PARSED_OK);
+    CHECK(unopenable(parser("--note"), "value"));
+
+    // An empty file gives an empty view.
+    std::string emptyRef = "@" + empty;
+    const char* blank[] = { "test", "--cert", emptyRef.c_str() };
+    CHECK(parser.parse(3, const_cast<char**>(blank)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--cert").content("value").size() == 0);
+
+    // A missing file only fails when the contents are read, and every read
+    // fails until a parse names a file that exists.
+    const char* absent[] = { "test", "--cert", missingRef.c_str(), "--key", missing.c_str() };
+    CHECK(parser.parse(5, const_cast<char**>(absent)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--cert").value("value") == missingRef);
+    CHECK(unopenable(parser("--cert"), "value"));
+    CHECK(unopenable(parser("--cert"), "value"));
+    CHECK(unopenable(parser("--key"), "value"));
+
+    parser.reset();
+    CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--cert").content("value").str() == "-----BEGIN CERT-----\n");
+
+    CHECK(output.str().empty());
+    CHECK(errors.str().empty());
+    ::unlink(cert.c_str());
+    ::unlink(other.c_str());
+    ::unlink(empty.c_str());
+    TEST_END();
+}
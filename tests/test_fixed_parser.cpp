@@ -0,0 +1,114 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <cstdlib>
+#include <new>
+
+// Counts every operator new made while counting is on. GCC flags the free()
+// in the replaced operator delete as mismatched once both are inlined.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static bool counting = false;
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    if (counting)
+        ++allocations;
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+// Stream buffer over a fixed array, so writing help allocates nothing.
+class FixedBuffer : public std::streambuf
+{
+public:
+    FixedBuffer()
+    {
+        setp(mData, mData + sizeof(mData));
+    }
+
+    std::string str() const
+    {
+        return std::string(pbase(), pptr());
+    }
+
+private:
+    char mData[1 << 14];
+};
+
+static bool check(cli::FixedParser<4>::Option&, void* context)
+{
+    ++*static_cast<int*>(context);
+    return true;
+}
+
+int main()
+{
+    int validated = 0;
+    cli::FixedParser<4> fixed("tool", "1.0", "A tool used to compare the help of both parsers, with a description long enough to wrap.");
+    cli::Parser parser("tool", "1.0", "A tool used to compare the help of both parsers, with a description long enough to wrap.");
+    fixed.addOption({"-n", "--name"}, "The name to greet.", true, {{"value", "The name."}}, check, &validated);
+    fixed.addOption({"-v"}, "Prints more.", false);
+    parser.addOptions({
+        {{"-n", "--name"}, "The name to greet.", true, {{"value", "The name."}}},
+        {{"-v"}, "Prints more.", false, {}},
+    });
+
+    // The counter sees allocations made from the library.
+    {
+        const char* argv[] = { "tool", "--name", "a value too long for the small string buffer" };
+        counting = true;
+        parser.parse(3, const_cast<char**>(argv));
+        counting = false;
+        CHECK(allocations > 0);
+        allocations = 0;
+        parser.reset();
+    }
+
+    // Parsing never allocates.
+    {
+        const char* argv[] = { "tool", "--name", "alice", "-v" };
+        counting = true;
+        cli::Parser::ParsingResult result = fixed.parse(4, const_cast<char**>(argv));
+        counting = false;
+        CHECK(result == cli::Parser::PARSED_OK);
+        CHECK(allocations == 0);
+        CHECK(validated == 1);
+        CHECK(std::string(fixed("-n")->value("value")) == "alice");
+        CHECK(fixed("-v")->provided());
+    }
+
+    // Help is written without allocating, and matches Parser's help.
+    {
+        FixedBuffer buffer;
+        std::streambuf* saved = std::cout.rdbuf(&buffer);
+        const char* argv[] = { "tool", "--help" };
+        allocations = 0;
+        counting = true;
+        cli::Parser::ParsingResult result = fixed.parse(2, const_cast<char**>(argv));
+        counting = false;
+        std::cout.rdbuf(saved);
+        CHECK(result == cli::Parser::PARSED_HELP);
+        CHECK(allocations == 0);
+
+        std::ostringstream expected;
+        parser.setStreams(expected, expected);
+        CHECK(parser.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_HELP);
+        CHECK(buffer.str() == expected.str());
+    }
+    TEST_END();
+}
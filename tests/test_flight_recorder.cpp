@@ -0,0 +1,112 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+typedef cli::FlightRecorder Recorder;
+
+static std::vector<uint64_t> dumpWords(const Recorder& recorder)
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/cli_parser_test_ring.XXXXXX";
+    int fd = ::mkstemp(&path[0]);
+    std::vector<uint64_t> words;
+    if (fd < 0)
+        return words;
+
+    ::unlink(path.c_str());
+    if (recorder.dump(fd) && ::lseek(fd, 0, SEEK_SET) == 0)
+    {
+        uint64_t word;
+        while (::read(fd, &word, sizeof(word)) == static_cast<ssize_t>(sizeof(word)))
+            words.push_back(word);
+    }
+    ::close(fd);
+    return words;
+}
+
+int main()
+{
+    // Capacity rounds up to a power of two.
+    Recorder recorder(5);
+    CHECK(recorder.capacity() == 8);
+
+    Recorder::Event events[16];
+    CHECK(recorder.snapshot(events, 16) == 0);
+
+    // Before the ring fills, every event is kept, oldest first.
+    for (size_t i = 0; i < 3; ++i)
+        recorder.record(Recorder::EVENT_OPTION, i, i + 100, 1);
+    CHECK(recorder.snapshot(events, 16) == 3);
+    for (size_t i = 0; i < 3; ++i)
+        CHECK(events[i].mToken == i && events[i].mOption == i + 100 && events[i].mDepth == 1);
+
+    // Overflow the ring: only the newest capacity() events survive, in order.
+    const size_t total = 21;
+    for (size_t i = 3; i < total; ++i)
+        recorder.record(static_cast<Recorder::EventKind>(i % 8), i, i * 3, static_cast<int>(i % 4));
+    CHECK(recorder.recorded() == total);
+    CHECK(recorder.snapshot(events, 16) == 8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        size_t expected = total - 8 + i;
+        CHECK(events[i].mToken == expected);
+        CHECK(events[i].mOption == expected * 3);
+        CHECK(events[i].mKind == expected % 8);
+        CHECK(events[i].mDepth == expected % 4);
+    }
+
+    // A smaller snapshot takes the newest events.
+    CHECK(recorder.snapshot(events, 3) == 3);
+    CHECK(events[0].mToken == total - 3 && events[2].mToken == total - 1);
+
+    // The dump is the raw ring: header, then slots in ring order. Reading
+    // from the head around the ring gives the same newest events in order.
+    std::vector<uint64_t> words = dumpWords(recorder);
+    CHECK(words.size() == 3 + 2 * 8);
+    if (words.size() == 3 + 2 * 8)
+    {
+        CHECK(std::memcmp(&words[0], "CLIFLTR1", 8) == 0);
+        CHECK(words[0] == Recorder::MAGIC);
+        CHECK((words[1] & ~(1ull << 63)) == 8);
+        CHECK(words[2] == total);
+        Recorder::Event newest[8];
+        recorder.snapshot(newest, 8);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            size_t slot = (words[2] + i) & 7;
+            uint64_t packed = words[3 + 2 * slot + 1];
+            CHECK(words[3 + 2 * slot] == newest[i].mTimestamp);
+            CHECK(static_cast<uint32_t>(packed) == total - 8 + i);
+            CHECK(static_cast<uint16_t>(packed >> 32) == (total - 8 + i) * 3);
+            CHECK(static_cast<uint8_t>(packed >> 48) == (total - 8 + i) % 8);
+        }
+    }
+
+    // A parser logs its events into the ring.
+    std::ostringstream sink;
+    cli::Parser parser("test");
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+    });
+    Recorder log(64);
+    parser.setFlightRecorder(&log);
+    const char* argv[] = { "test", "--name", "bob", "--bogus" };
+    CHECK(parser.parse(4, const_cast<char**>(argv)) == cli::Parser::PARSED_FAILED);
+    size_t count = log.snapshot(events, 16);
+    CHECK(count == 5);
+    if (count == 5)
+    {
+        CHECK(events[0].mKind == Recorder::EVENT_PARSE_BEGIN && events[0].mToken == 4);
+        CHECK(events[1].mKind == Recorder::EVENT_OPTION && events[1].mToken == 1);
+        CHECK(events[2].mKind == Recorder::EVENT_VALUE && events[2].mToken == 2);
+        CHECK(events[2].mOption == events[1].mOption);
+        CHECK(events[3].mKind == Recorder::EVENT_UNKNOWN && events[3].mToken == 3);
+        CHECK(events[4].mKind == Recorder::EVENT_PARSE_END);
+        CHECK(events[4].mToken == static_cast<uint32_t>(cli::Parser::PARSED_FAILED));
+    }
+    TEST_END();
+}
@@ -0,0 +1,90 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <thread>
+
+static void addOptions(cli::Parser& parser, std::ostream& sink)
+{
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--name", "-n"}, "Name.", false, {{"value", "The name."}}},
+        {{"--size"}, "Size.", false, {{"width", "The width."}, {"height", "The height."}}},
+        {{"-v"}, "Verbose.", false, {}},
+    });
+}
+
+static std::string read(const cli::FrozenOptions::Replica& replica, size_t slot)
+{
+    return std::string(replica.value(slot), replica.length(slot));
+}
+
+int main()
+{
+    std::ostringstream sink;
+    cli::Parser parser("test");
+    addOptions(parser, sink);
+    const char* argv[] = { "test", "-n", "alice", "--size", "640", "" };
+    CHECK(parser.parse(6, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    std::shared_ptr<const cli::FrozenOptions> frozen = parser.freeze();
+
+    size_t name = frozen->valueSlot("--name", "value");
+    size_t width = frozen->valueSlot("--size", "width");
+    size_t height = frozen->valueSlot("--size", "height");
+
+    // The snapshot holds the parser's values, under every spelling, and
+    // survives a reset of the parser.
+    parser.reset();
+    {
+        const cli::FrozenOptions::Replica& replica = frozen->local();
+        CHECK(&replica == &frozen->local());
+        CHECK(frozen->valueSlot("-n", "value") == name);
+        CHECK(read(replica, name) == "alice");
+        CHECK(read(replica, width) == "640");
+        CHECK(read(replica, height).empty());
+        CHECK(replica.provided(frozen->optionSlot("--name")));
+        CHECK(replica.provided(frozen->optionSlot("--size")));
+        CHECK(!replica.provided(frozen->optionSlot("-v")));
+    }
+
+    // A second snapshot read from the same thread has its own values.
+    {
+        const char* other[] = { "test", "--name", "bob", "-v" };
+        CHECK(parser.parse(4, const_cast<char**>(other)) == cli::Parser::PARSED_OK);
+        std::shared_ptr<const cli::FrozenOptions> second = parser.freeze();
+        CHECK(read(second->local(), second->valueSlot("--name", "value")) == "bob");
+        CHECK(second->local().provided(second->optionSlot("-v")));
+        CHECK(read(frozen->local(), name) == "alice");
+    }
+
+    // Other threads read the same values through their own local().
+    {
+        std::atomic<int> wrong(0);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&] {
+                for (int n = 0; n < 1000; ++n)
+                {
+                    const cli::FrozenOptions::Replica& replica = frozen->local();
+                    if (read(replica, name) != "alice" || read(replica, width) != "640")
+                        ++wrong;
+                }
+            });
+        }
+        for (auto& reader : readers)
+            reader.join();
+        CHECK(wrong == 0);
+    }
+
+    bool threw = false;
+    try
+    {
+        frozen->valueSlot("--name", "missing");
+    }
+    catch (const cli::ParsingException&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    TEST_END();
+}
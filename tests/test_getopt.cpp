@@ -0,0 +1,60 @@
+#define CLI_GETOPT_IMPLEMENTATION
+#include "cli_getopt.h"
+#include "test.h"
+
+#include <cstring>
+
+int main()
+{
+    char program[] = "test";
+    char shortArg[] = "-x";
+    char longArg[] = "--colour";
+    char prefixArg[] = "--col";
+    cli_opterr = 0;
+
+    // The same optstring buffer, rewritten between scans.
+    char optstring[8];
+    std::strcpy(optstring, "x");
+    {
+        char* argv[] = { program, shortArg, nullptr };
+        cli_optind = 1;
+        CHECK(cli_getopt(2, argv, optstring) == 'x');
+        CHECK(cli_getopt(2, argv, optstring) == -1);
+    }
+    std::strcpy(optstring, "y");
+    {
+        char* argv[] = { program, shortArg, nullptr };
+        cli_optind = 1;
+        CHECK(cli_getopt(2, argv, optstring) == '?');
+    }
+
+    // The same long option table, rebuilt with other names.
+    cli_option longopts[3];
+    longopts[0] = { "colour", cli_no_argument, nullptr, 'c' };
+    longopts[1] = { "column", cli_no_argument, nullptr, 'k' };
+    longopts[2] = { nullptr, 0, nullptr, 0 };
+    {
+        char* argv[] = { program, longArg, prefixArg, nullptr };
+        cli_optind = 1;
+        CHECK(cli_getopt_long(3, argv, "", longopts, nullptr) == 'c');
+        CHECK(cli_getopt_long(3, argv, "", longopts, nullptr) == '?');
+    }
+    longopts[0] = { "color", cli_no_argument, nullptr, 'C' };
+    longopts[1] = { "collate", cli_no_argument, nullptr, 'l' };
+    {
+        char* argv[] = { program, longArg, prefixArg, nullptr };
+        cli_optind = 1;
+        CHECK(cli_getopt_long(3, argv, "", longopts, nullptr) == '?');
+        CHECK(cli_getopt_long(3, argv, "", longopts, nullptr) == '?');
+    }
+    longopts[1] = { "collate", cli_no_argument, nullptr, 'C' };
+    {
+        // Prefixes naming equivalent entries are not ambiguous.
+        char* argv[] = { program, prefixArg, nullptr };
+        cli_optind = 1;
+        int index = -1;
+        CHECK(cli_getopt_long(2, argv, "", longopts, &index) == 'C');
+        CHECK(index == 0);
+    }
+    TEST_END();
+}
@@ -0,0 +1,55 @@
+// std: c++17
+// sources: getopt_replace.c
+#define CLI_GETOPT_IMPLEMENTATION
+#define CLI_GETOPT_REPLACE
+#include "cli_getopt.h"
+#include "test.h"
+
+#include <getopt.h>
+#include <unistd.h>
+
+extern "C" int run_c_getopt(int argc, char** argv, char* name, size_t size);
+
+int main()
+{
+    char program[] = "test";
+    char name[] = "--name=bob";
+    char verbose[] = "-v";
+    char operand[] = "file";
+
+    // A standard getopt_long loop, compiled against the replacement names.
+    {
+        static const struct option longopts[] = {
+            { "name", required_argument, nullptr, 'n' },
+            { "verbose", no_argument, nullptr, 'v' },
+            { nullptr, 0, nullptr, 0 },
+        };
+        char* argv[] = { program, operand, name, verbose, nullptr };
+        std::string value;
+        bool loud = false;
+        int index = -1;
+        int c;
+        optind = 1;
+        while ((c = getopt_long(4, argv, "n:v", longopts, &index)) != -1)
+        {
+            if (c == 'n')
+                value = optarg;
+            else if (c == 'v')
+                loud = true;
+        }
+        CHECK(value == "bob");
+        CHECK(loud);
+        CHECK(optind == 3);
+        CHECK(std::string(argv[3]) == "file");
+        CHECK(&optind == &cli_optind);
+    }
+
+    // The same loop written in C.
+    {
+        char* argv[] = { program, name, verbose, operand, nullptr };
+        char value[16] = "";
+        CHECK(run_c_getopt(4, argv, value, sizeof(value)) == 103);
+        CHECK(std::string(value) == "bob");
+    }
+    TEST_END();
+}
@@ -0,0 +1,110 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <type_traits>
+
+static_assert(std::is_copy_constructible<cli::Parser>::value && std::is_copy_assignable<cli::Parser>::value, "Parser must stay copyable");
+static_assert(std::is_move_constructible<cli::Parser>::value && std::is_move_assignable<cli::Parser>::value, "Parser must stay movable");
+
+static cli::Parser makeParser(std::ostream& sink)
+{
+    cli::Parser parser("test", "1.0", "A test program.");
+    parser.setStreams(sink, sink);
+    parser.setDeferredIndexing(true);
+    for (int i = 0; i < 200; ++i)
+    {
+        cli::Parser::Option option({"--option-" + std::to_string(i)}, "An option.", false, {{"value", "The value."}});
+        parser.addOption(option);
+    }
+    return parser;
+}
+
+static uint64_t hash(const std::string& key, uint64_t seed)
+{
+    return cli::KeyHash::hash(key.data(), key.size(), seed);
+}
+
+int main()
+{
+    // Every key length depends on the seed, including those shorter than a word.
+    {
+        int seedIndependent = 0;
+        for (int length = 0; length <= 24; ++length)
+        {
+            std::string key(length, 'k');
+            if (hash(key, 1) == hash(key, 2) || hash(key, 1) == hash(key, 1ull << 63))
+                ++seedIndependent;
+        }
+        CHECK(seedIndependent == 0);
+        CHECK(hash("a", 1) != hash("b", 1));
+        CHECK(hash("", 1) != hash(std::string(1, '\0'), 1));
+    }
+
+    // Keys chosen to share a bucket under one seed spread out under another,
+    // and a table holding them still finds each one.
+    {
+        const uint64_t known = 0x0123456789ABCDEFull;
+        std::vector<std::string> colliding;
+        for (int i = 0; colliding.size() < 64; ++i)
+        {
+            std::string key = "--k" + std::to_string(i);
+            if ((hash(key, known) & 1023) == 0)
+                colliding.push_back(key);
+        }
+
+        std::vector<int> buckets(1024);
+        int deepest = 0;
+        for (const auto& key : colliding)
+            deepest = std::max(deepest, ++buckets[hash(key, known + 1) & 1023]);
+        CHECK(deepest < 8);
+
+        cli::HashIndex<int> index;
+        for (size_t i = 0; i < colliding.size(); ++i)
+            index.insert(colliding[i], static_cast<int>(i) + 1);
+        int found = 0;
+        for (size_t i = 0; i < colliding.size(); ++i)
+            found += index.find(colliding[i]) == static_cast<int>(i) + 1;
+        CHECK(found == static_cast<int>(colliding.size()));
+        CHECK(index.find("--k-missing") == 0);
+    }
+
+    std::ostringstream sink;
+    const char* argv[] = { "test", "--option-7", "seven" };
+
+    // Moving a parser while its index is built in the background.
+    {
+        cli::Parser source = makeParser(sink);
+        source.buildIndexAsync();
+        cli::Parser moved(std::move(source));
+        CHECK(moved.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(moved("--option-7").value("value") == "seven");
+
+        cli::Parser assigned("other");
+        assigned.buildIndexAsync();
+        assigned = std::move(moved);
+        CHECK(assigned("--option-7").value("value") == "seven");
+    }
+
+    // A copy made while the source's build is pending has its own options.
+    {
+        cli::Parser source = makeParser(sink);
+        source.buildIndexAsync(true);
+        cli::Parser copy(source);
+        CHECK(copy.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(&copy("--option-7") != &source("--option-7"));
+        CHECK(copy("--option-7").value("value") == "seven");
+        CHECK(source("--option-7").value("value").empty());
+
+        cli::Parser assigned("other");
+        assigned = copy;
+        CHECK(&assigned("--option-7") != &copy("--option-7"));
+        CHECK(assigned("--option-7").value("value") == "seven");
+    }
+
+    // Destroying a parser with a build still pending.
+    {
+        cli::Parser source = makeParser(sink);
+        source.buildIndexAsync();
+    }
+    TEST_END();
+}
@@ -0,0 +1,56 @@
+#include "cli_parser.h"
+#include "test.h"
+
+int main()
+{
+    // Ids are dense, stable and equal exactly for equal values.
+    {
+        cli::InternPool pool;
+        std::vector<uint32_t> ids;
+        for (int i = 0; i < 100000; ++i)
+            ids.push_back(pool.intern("value-" + std::to_string(i)));
+        CHECK(pool.count() == 100000);
+
+        int wrong = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            std::string value = "value-" + std::to_string(i);
+            wrong += ids[i] != static_cast<uint32_t>(i) || pool.intern(value) != ids[i] || pool.str(ids[i]) != value;
+        }
+        CHECK(wrong == 0);
+        CHECK(pool.count() == 100000);
+        CHECK(pool.intern("", 0) == pool.intern(std::string()));
+    }
+
+    // Each table has its own seed, so a value set that collides in one
+    // table does not collide in another.
+    {
+        cli::IdTable first;
+        cli::IdTable second;
+        CHECK(first.hash("queue", 5) != second.hash("queue", 5));
+        CHECK(first.hash("", 0) != second.hash("", 0));
+    }
+
+    // Values shared by parsers through the pool.
+    {
+        std::ostringstream sink;
+        cli::InternPool pool;
+        cli::Parser first;
+        cli::Parser second;
+        for (cli::Parser* parser : { &first, &second })
+        {
+            parser->setStreams(sink, sink);
+            parser->setInternPool(&pool);
+            parser->addOptions({
+                {{"--queue"}, "Queue.", false, {{"name", "The queue."}}},
+            });
+        }
+
+        const char* argv[] = { "test", "--queue", "batch" };
+        CHECK(first.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(second.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(first("--queue").internId("name") == second("--queue").internId("name"));
+        CHECK(pool.str(first("--queue").internId("name")) == "batch");
+    }
+    TEST_END();
+}
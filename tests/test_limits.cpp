@@ -0,0 +1,89 @@
+#define CLI_PARALLEL_PARSE_THRESHOLD 8
+#include "cli_parser.h"
+#include "test.h"
+
+#include <fstream>
+
+static std::string tempPath(const char* name)
+{
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir != nullptr ? dir : "/tmp") + "/" + name;
+}
+
+static std::string writeFile(const char* name, const std::string& text)
+{
+    std::string path = tempPath(name);
+    std::ofstream(path.c_str()) << text;
+    return path;
+}
+
+static void addOptions(cli::Parser& parser, std::ostream& sink)
+{
+    parser.setStreams(sink, sink);
+    parser.setResponseFiles(true);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+        {{"-v"}, "Verbose.", false},
+    });
+}
+
+int main()
+{
+    std::ostringstream sink;
+    std::string inner = writeFile("cli_parser_test_inner.rsp", "--name bob\n");
+    std::string outer = writeFile("cli_parser_test_outer.rsp", "-v @" + inner + "\n");
+    std::string token = "@" + outer;
+    const char* argv[] = { "test", token.c_str() };
+
+    // Value-initialized limits are all unlimited, response file depth included.
+    {
+        cli::Parser parser("test");
+        addOptions(parser, sink);
+        parser.setLimits(cli::Parser::Limits());
+        CHECK(parser.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(parser("--name").value("value") == "bob");
+    }
+
+    // A depth limit still applies when set.
+    {
+        cli::Parser parser("test");
+        addOptions(parser, sink);
+        cli::Parser::Limits limits = cli::Parser::Limits();
+        limits.mMaxResponseFileDepth = 1;
+        parser.setLimits(limits);
+        CHECK(parser.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_FAILED_LIMIT);
+        CHECK(parser.limitExceeded() == cli::Parser::LIMIT_RESPONSE_FILE_DEPTH);
+    }
+
+    // Without a depth limit, a file including itself fails instead of recursing.
+    {
+        // The file names itself through a different spelling of its path.
+        std::string loop = writeFile("cli_parser_test_loop.rsp", "-v @" + tempPath("./cli_parser_test_loop.rsp") + "\n");
+        std::string loopToken = "@" + loop;
+        const char* loopArgv[] = { "test", loopToken.c_str() };
+        cli::Parser parser("test");
+        addOptions(parser, sink);
+        parser.setLimits(cli::Parser::Limits());
+        CHECK(parser.parse(2, const_cast<char**>(loopArgv)) == cli::Parser::PARSED_FAILED);
+        CHECK(sink.str().find("Recursive response file") != std::string::npos);
+        std::remove(loop.c_str());
+    }
+
+    // A token budget smaller than a bulk-resolved argv stops at the first excess token.
+    {
+        std::vector<const char*> many(64, "-v");
+        many[0] = "test";
+        cli::Parser parser("test");
+        addOptions(parser, sink);
+        cli::Parser::Limits limits = cli::Parser::Limits();
+        limits.mMaxTokens = 100;
+        limits.mMaxTotalBytes = 40;
+        parser.setLimits(limits);
+        CHECK(parser.parse(static_cast<int>(many.size()), const_cast<char**>(many.data())) == cli::Parser::PARSED_FAILED_LIMIT);
+        CHECK(parser.limitExceeded() == cli::Parser::LIMIT_TOTAL_BYTES);
+    }
+
+    std::remove(inner.c_str());
+    std::remove(outer.c_str());
+    TEST_END();
+}
@@ -0,0 +1,45 @@
+#include "cli_parser.h"
+#include "test.h"
+
+int main()
+{
+    std::ostringstream sink;
+    cli::Parser child("tool");
+    child.setStreams(sink, sink);
+    child.addOptions({
+        {{"--a"}, "A.", false, {{"value", "The value."}}},
+        {{"--b"}, "B.", false, {}},
+    });
+    cli::Parser parser("outer");
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--exec"}, "Command to run.", false, {{"cmd", "Command to run.", child}}},
+    });
+
+    // The README example: the first embedded token is the program name.
+    {
+        const char* argv[] = { "outer", "--exec", "tool --a 1" };
+        CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(parser("--exec").child("cmd")("--a").value("value") == "1");
+    }
+
+    // Quoted and escaped values are split like a response file.
+    {
+        const char* argv[] = { "outer", "--exec", "tool --a \"one two\" --b" };
+        parser.reset();
+        CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(parser("--exec").child("cmd")("--a").value("value") == "one two");
+    }
+
+    // The parent fails when the child does.
+    {
+        const char* argv[] = { "outer", "--exec", "tool --c" };
+        parser.reset();
+        CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_FAILED);
+
+        const char* unterminated[] = { "outer", "--exec", "tool --a \"one" };
+        parser.reset();
+        CHECK(parser.parse(3, const_cast<char**>(unterminated)) == cli::Parser::PARSED_FAILED);
+    }
+    TEST_END();
+}
@@ -0,0 +1,89 @@
+#define CLI_PARALLEL_PARSE_THRESHOLD 8
+#define CLI_PARALLEL_PARSE_CHUNK 64
+#include "cli_parser.h"
+#include "test.h"
+
+#include <random>
+
+struct Outcome
+{
+    cli::Parser::ParsingResult mResult;
+    std::string mErrors;
+    std::vector<std::string> mValues;
+};
+
+// Parses argv with the parallel lookup on or off and records everything the
+// parse produced.
+static Outcome run(const std::vector<std::string>& tokens, bool parallel)
+{
+    std::ostringstream errors;
+    cli::Parser parser("test");
+    parser.setStreams(errors, errors);
+    parser.setParallelResolve(parallel);
+    parser.addOptions({
+        {{"--name", "-n"}, "Name.", false, {{"value", "The name."}}},
+        {{"--size"}, "Size.", false, {{"width", "The width."}, {"height", "The height."}}},
+        {{"-v"}, "Verbose.", false, {}},
+    });
+
+    std::vector<char*> argv;
+    for (const auto& token : tokens)
+        argv.push_back(const_cast<char*>(token.c_str()));
+
+    Outcome outcome;
+    outcome.mResult = parser.parse(static_cast<int>(argv.size()), argv.data());
+    outcome.mErrors = errors.str();
+    outcome.mValues.push_back(parser("--name").value("value"));
+    outcome.mValues.push_back(parser("--size").value("width"));
+    outcome.mValues.push_back(parser("--size").value("height"));
+    return outcome;
+}
+
+static bool same(const Outcome& a, const Outcome& b)
+{
+    return a.mResult == b.mResult && a.mErrors == b.mErrors && a.mValues == b.mValues;
+}
+
+int main()
+{
+    // Option spellings are also used as values, so only the scan can tell
+    // which tokens are consumed as arguments.
+    static const char* const words[] = { "--name", "-n", "--size", "-v", "x", "12" };
+    std::mt19937 random(82);
+    std::vector<std::string> tokens = { "test" };
+    while (tokens.size() < 20000)
+    {
+        switch (random() % 3)
+        {
+        case 0:
+            tokens.push_back("--name");
+            tokens.push_back(words[random() % 6]);
+            break;
+        case 1:
+            tokens.push_back("--size");
+            tokens.push_back(words[random() % 6]);
+            tokens.push_back(std::to_string(random() % 100));
+            break;
+        default:
+            tokens.push_back("-v");
+            break;
+        }
+    }
+
+    Outcome serial = run(tokens, false);
+    Outcome parallel = run(tokens, true);
+    CHECK(serial.mResult == cli::Parser::PARSED_OK);
+    CHECK(same(serial, parallel));
+
+    // With several invalid tokens, both report the first one only.
+    std::vector<std::string> invalid = tokens;
+    invalid.insert(invalid.begin() + 15001, "--late");
+    invalid.insert(invalid.begin() + 5001, "--early");
+    serial = run(invalid, false);
+    parallel = run(invalid, true);
+    CHECK(serial.mResult == cli::Parser::PARSED_FAILED);
+    CHECK(serial.mErrors.find("--early") != std::string::npos);
+    CHECK(serial.mErrors.find("--late") == std::string::npos);
+    CHECK(same(serial, parallel));
+    TEST_END();
+}
@@ -0,0 +1,85 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <vector>
+
+typedef std::vector<std::string> Tokens;
+
+static Tokens tokens(int argc, const std::vector<char*>& argv)
+{
+    return Tokens(argv.begin(), argv.begin() + argc);
+}
+
+static std::vector<char*> makeArgv(const Tokens& source)
+{
+    std::vector<char*> argv;
+    for (const auto& token : source)
+        argv.push_back(const_cast<char*>(token.c_str()));
+    argv.push_back(nullptr);
+    return argv;
+}
+
+int main()
+{
+    std::ostringstream output;
+    std::ostringstream errors;
+    cli::Parser parser("test");
+    parser.setStreams(output, errors);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+        {{"--verbose"}, "Verbose.", false, {}},
+    });
+
+    // Own options are consumed and everything else keeps its order at the front.
+    Tokens mixed = { "test", "--other", "--name", "bob", "-x", "1", "--verbose", "@extra", "--help", "--", "--name", "tail" };
+    std::vector<char*> argv = makeArgv(mixed);
+    int argc = static_cast<int>(mixed.size());
+    CHECK(parser.parseKnown(argc, argv.data()) == cli::Parser::PARSED_OK);
+    CHECK(tokens(argc, argv) == Tokens({ "test", "--other", "-x", "1", "@extra", "--help", "--", "--name", "tail" }));
+    CHECK(argv[argc] == nullptr);
+    CHECK(parser("--name").value("value") == "bob");
+    CHECK(output.str().empty());
+
+    // A second parser takes its share of what is left.
+    cli::Parser next("next");
+    next.setStreams(output, errors);
+    next.addOptions({
+        {{"--other"}, "Other.", false, {}},
+        {{"-x"}, "X.", false, {{"value", "The x."}}},
+    });
+    CHECK(next.parseKnown(argc, argv.data()) == cli::Parser::PARSED_OK);
+    CHECK(tokens(argc, argv) == Tokens({ "test", "@extra", "--help", "--", "--name", "tail" }));
+    CHECK(argv[argc] == nullptr);
+    CHECK(next("-x").value("value") == "1");
+
+    // Only own options: just the program name remains.
+    Tokens own = { "test", "--verbose", "--name", "amy" };
+    argv = makeArgv(own);
+    argc = 4;
+    CHECK(parser.parseKnown(argc, argv.data()) == cli::Parser::PARSED_OK);
+    CHECK(tokens(argc, argv) == Tokens({ "test" }));
+    CHECK(argv[1] == nullptr);
+
+    // Nothing of ours: argv is left as it was.
+    Tokens foreign = { "test", "a", "b" };
+    argv = makeArgv(foreign);
+    argc = 3;
+    CHECK(parser.parseKnown(argc, argv.data()) == cli::Parser::PARSED_OK);
+    CHECK(tokens(argc, argv) == foreign);
+
+    // A failure after some tokens were passed through and some consumed
+    // leaves argc and argv exactly as they were, so no token is lost.
+    Tokens failing = { "test", "--keep", "--verbose", "-y", "--name" };
+    argv = makeArgv(failing);
+    std::vector<char*> before = argv;
+    argc = 5;
+    CHECK(parser.parseKnown(argc, argv.data()) == cli::Parser::PARSED_FAILED);
+    CHECK(argc == 5);
+    CHECK(argv == before);
+    CHECK(errors.str().find("Missing argument {'value'} for parameter '--name'") != std::string::npos);
+
+    // The failed call does not leave the parser in pass-through mode.
+    CHECK(parser.parse(3, argv.data()) == cli::Parser::PARSED_FAILED);
+    CHECK(errors.str().find("Invalid argument {'--keep'}") != std::string::npos);
+    TEST_END();
+}
@@ -0,0 +1,113 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <random>
+
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// '+' is a space and %XX a byte; a '%' not followed by two hex digits is kept.
+static std::string referenceDecode(const std::string& text)
+{
+    std::string out;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '+')
+            out += ' ';
+        else if (text[i] == '%' && i + 2 < text.size() && hexDigit(text[i + 1]) >= 0 && hexDigit(text[i + 2]) >= 0)
+        {
+            out += static_cast<char>(hexDigit(text[i + 1]) << 4 | hexDigit(text[i + 2]));
+            i += 2;
+        }
+        else
+            out += text[i];
+    }
+    return out;
+}
+
+static void addOptions(cli::Parser& parser, std::ostream& sink)
+{
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+        {{"--size"}, "Size.", false, {{"width", "The width."}, {"height", "The height."}}},
+        {{"-v"}, "Verbose.", false, {}},
+    });
+}
+
+int main()
+{
+    std::ostringstream sink;
+    cli::Parser parser;
+    addOptions(parser, sink);
+
+    // Escapes, '+', repeated keys and key.argId.
+    {
+        CHECK(parser.parseQuery("?name=a+b%20c%2Bd&size=1&size.height=2&v") == cli::Parser::PARSED_OK);
+        CHECK(parser("--name").value("value") == "a b c+d");
+        CHECK(parser("--size").value("width") == "1");
+        CHECK(parser("--size").value("height") == "2");
+
+        parser.reset();
+        CHECK(parser.parseQuery("%2D%2Dname=x&") == cli::Parser::PARSED_OK);
+        CHECK(parser("--name").value("value") == "x");
+    }
+
+    // Malformed escapes are kept as they are.
+    {
+        parser.reset();
+        CHECK(parser.parseQuery("name=%zz%4%") == cli::Parser::PARSED_OK);
+        CHECK(parser("--name").value("value") == "%zz%4%");
+
+        parser.reset();
+        CHECK(parser.parseQuery("unknown=1") == cli::Parser::PARSED_FAILED);
+    }
+
+    // Random values, long enough for the 16-byte path, against the reference.
+    {
+        static const char alphabet[] = "ab%+09AFfgz";
+        std::mt19937 random(79);
+        int mismatches = 0;
+        for (int n = 0; n < 20000; ++n)
+        {
+            std::string value(random() % 80, 'a');
+            for (auto& c : value)
+                c = alphabet[random() % (sizeof(alphabet) - 1)];
+
+            parser.reset();
+            if (parser.parseQuery("name=" + value) != cli::Parser::PARSED_OK || parser("--name").value("value") != referenceDecode(value))
+                ++mismatches;
+        }
+        CHECK(mismatches == 0);
+    }
+
+    // A query is charged against the token and time budgets like argv.
+    {
+        std::string query = "v";
+        for (int i = 0; i < 600; ++i)
+            query += "&v";
+
+        cli::Parser::Limits limits = {};
+        limits.mMaxTokens = 100;
+        parser.setLimits(limits);
+        parser.reset();
+        CHECK(parser.parseQuery(query) == cli::Parser::PARSED_FAILED_LIMIT);
+        CHECK(parser.limitExceeded() == cli::Parser::LIMIT_TOKENS);
+
+        limits.mMaxTokens = 0;
+        limits.mTimeBudget = std::chrono::nanoseconds(1);
+        parser.setLimits(limits);
+        parser.reset();
+        CHECK(parser.parseQuery(query) == cli::Parser::PARSED_FAILED_LIMIT);
+        CHECK(parser.limitExceeded() == cli::Parser::LIMIT_TIME);
+    }
+    TEST_END();
+}
@@ -0,0 +1,72 @@
+// sources: registry_other.cpp
+#include "cli_parser.h"
+#include "test.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if CLI_HAS_OPTION_REGISTRY
+CLI_DEFINE_STRING(test_name, "--test-name", "none", "A registered string.");
+CLI_DEFINE_INT(test_count, "--test-count", 0, "A registered integer.");
+CLI_DEFINE_BOOL(test_flag, "--test-flag", "A registered switch.");
+CLI_DECLARE_STRING(other_mode)
+CLI_DECLARE_INT(other_level)
+#endif
+
+int main()
+{
+#if CLI_HAS_OPTION_REGISTRY
+    std::ostringstream sink;
+    {
+        const char* argv[] = { "test", "--test-name", "alice", "--test-count", "010", "--test-flag" };
+        cli::Parser parser("test");
+        parser.setStreams(sink, sink);
+        parser.addRegisteredOptions();
+        CHECK(parser.parse(6, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+
+        // Integers are decimal: a leading zero is not an octal prefix.
+        CHECK(cli_flags::test_count == 10);
+        CHECK(cli_flags::test_flag);
+
+        parser.reset();
+        CHECK(std::strcmp(cli_flags::test_name, "alice") == 0);
+    }
+
+    // The string outlives the parser that set it (ASan reports any dangling read).
+    CHECK(std::strcmp(cli_flags::test_name, "alice") == 0);
+
+    // Options from both translation units are registered, with their defaults.
+    {
+        CHECK(std::strcmp(cli_flags::other_mode, "fast") == 0);
+        CHECK(cli_flags::other_level == 3);
+
+        std::vector<std::string> names;
+        for (cli::Registry::Iterator it = cli::Registry::begin(); it != cli::Registry::end(); ++it)
+            names.push_back((*it)->mName);
+        CHECK(std::count(names.begin(), names.end(), "--test-name") == 1);
+        CHECK(std::count(names.begin(), names.end(), "--other-mode") == 1);
+        CHECK(std::count(names.begin(), names.end(), "--other-level") == 1);
+
+        const char* argv[] = { "test", "--other-mode", "slow", "--other-level", "7" };
+        cli::Parser parser("test");
+        parser.setStreams(sink, sink);
+        parser.addRegisteredOptions();
+        CHECK(parser.parse(5, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+        CHECK(std::strcmp(cli_flags::other_mode, "slow") == 0);
+        CHECK(cli_flags::other_level == 7);
+    }
+
+    // A moved parser keeps reporting through its own streams.
+    {
+        cli::Parser first("test");
+        first.setStreams(sink, sink);
+        first.addRegisteredOptions();
+        cli::Parser parser(std::move(first));
+
+        const char* argv[] = { "test", "--test-count", "12x" };
+        CHECK(parser.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_FAILED_VALIDATOR);
+        CHECK(sink.str().find("Invalid value {'12x'}") != std::string::npos);
+    }
+#endif
+    TEST_END();
+}
@@ -0,0 +1,80 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <fstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static std::string writeFile(const char* name, const char* text)
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/" + name;
+    std::ofstream(path.c_str()) << text;
+    return path;
+}
+
+int main()
+{
+    std::string path = writeFile("cli_parser_test.rsp", "--name bob\n");
+    std::string token = "@" + path;
+    std::ostringstream sink;
+
+    cli::Parser parser("test");
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+    });
+
+    // "@path" is an ordinary (invalid) token unless expansion is enabled.
+    const char* argv[] = { "test", token.c_str() };
+    CHECK(parser.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_FAILED);
+
+    parser.reset();
+    parser.setResponseFiles(true);
+    CHECK(parser.parse(2, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    CHECK(parser("--name").value("value") == "bob");
+
+    // A command line embedded in a value never reads files, even when the
+    // child parser expands them for its own command line.
+    cli::Parser child("child");
+    child.setStreams(sink, sink);
+    child.setResponseFiles(true);
+    child.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+    });
+    cli::Parser outer("outer");
+    outer.setStreams(sink, sink);
+    outer.addOptions({
+        {{"--exec"}, "Command.", false, {{"cmd", "The command.", child}}},
+    });
+    std::string command = "tool " + token;
+    const char* nested[] = { "outer", "--exec", command.c_str() };
+    CHECK(outer.parse(3, const_cast<char**>(nested)) == cli::Parser::PARSED_FAILED);
+
+    std::remove(path.c_str());
+
+    // A page-sized file ending in a cooked token that unescaping does not
+    // shorten: a backslash with nothing left to escape. The mapping is
+    // steered into a hole directly below an inaccessible page, so writing a
+    // terminator past the end of the file would fault.
+    {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        std::string text;
+        while (text.size() < page - 2)
+            text += "a ";
+        text += "x\\";
+        std::string tail = writeFile("cli_parser_tail.rsp", text.c_str());
+
+        char* guard = static_cast<char*>(mmap(nullptr, 2 * page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        CHECK(guard != MAP_FAILED);
+        munmap(guard, page);
+
+        cli::ResponseFile file(tail);
+        CHECK(file.count() == static_cast<int>((page - 2) / 2 + 1));
+        CHECK(std::string(file.tokens()[file.count() - 1]) == "x\\");
+        CHECK(std::string(file.tokens()[0]) == "a");
+        munmap(guard + page, page);
+        std::remove(tail.c_str());
+    }
+    TEST_END();
+}
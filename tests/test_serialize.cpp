@@ -0,0 +1,47 @@
+#include "cli_parser.h"
+#include "test.h"
+
+static std::string record(const char* value)
+{
+    std::ostringstream sink;
+    cli::Parser parser("tool");
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--name"}, "Name.", false, {{"value", "The name."}}},
+    });
+    const char* argv[] = { "tool", "--name", value };
+    if (parser.parse(3, const_cast<char**>(argv)) != cli::Parser::PARSED_OK)
+        return std::string();
+
+    char buffer[256];
+    size_t length = parser.serialize(buffer, sizeof(buffer));
+    return length <= sizeof(buffer) ? std::string(buffer, length) : std::string();
+}
+
+static bool ascii(const std::string& text)
+{
+    for (unsigned char c : text)
+        if (c >= 0x80)
+            return false;
+    return true;
+}
+
+int main()
+{
+    // Valid UTF-8 is copied as is; quotes and control characters are escaped.
+    CHECK(record("caf\xc3\xa9").find("\"value\":\"caf\xc3\xa9\"") != std::string::npos);
+    CHECK(record("a\"b\x01").find("\"value\":\"a\\\"b\\u0001\"") != std::string::npos);
+
+    // Anything that is not valid UTF-8 has its high bytes escaped.
+    std::string invalid = record("\xff\xfe");
+    CHECK(invalid.find("\"value\":\"\\u00ff\\u00fe\"") != std::string::npos);
+    CHECK(ascii(invalid));
+
+    std::string truncated = record("caf\xc3");
+    CHECK(truncated.find("\"value\":\"caf\\u00c3\"") != std::string::npos);
+    CHECK(ascii(truncated));
+
+    std::string surrogate = record("\xed\xa0\x80");
+    CHECK(surrogate.find("\"value\":\"\\u00ed\\u00a0\\u0080\"") != std::string::npos);
+    TEST_END();
+}
@@ -0,0 +1,162 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <cstring>
+
+typedef cli::Parser Parser;
+
+// Parses "--v value" for an argument with the given checks and returns
+// whether it was accepted; typed holds Option::typed() afterwards.
+static bool accepts(unsigned checks, const char* value, cli::TypedValue& typed)
+{
+    std::ostringstream sink;
+    Parser parser("test");
+    parser.setStreams(sink, sink);
+    parser.addOptions({{{"--v"}, "Value.", false, {{"value", "The value.", checks}}}});
+    const char* argv[] = { "test", "--v", value };
+    Parser::ParsingResult result = parser.parse(3, const_cast<char**>(argv));
+    typed = parser("--v").typed("value");
+    return result == Parser::PARSED_OK;
+}
+
+static bool accepts(unsigned checks, const char* value)
+{
+    cli::TypedValue typed;
+    return accepts(checks, value, typed);
+}
+
+static bool empty(const cli::TypedValue& typed)
+{
+    static const cli::TypedValue zero = cli::TypedValue();
+    return std::memcmp(typed.mData, zero.mData, sizeof(zero.mData)) == 0 && typed.mFamily == 0 && typed.mPrefix == 0
+        && typed.mPort == 0 && typed.mNanoseconds == 0 && typed.mSeconds == 0;
+}
+
+static bool bytes(const cli::TypedValue& typed, const unsigned char* expected, size_t count)
+{
+    return std::memcmp(typed.mData, expected, count) == 0;
+}
+
+static bool seconds(const char* value, int64_t expected, uint32_t nanoseconds = 0)
+{
+    cli::TypedValue typed;
+    return accepts(Parser::TYPE_TIMESTAMP, value, typed) && typed.mSeconds == expected && typed.mNanoseconds == nanoseconds;
+}
+
+int main()
+{
+    cli::TypedValue typed;
+
+    // IPv4
+    static const unsigned char v4[] = { 192, 168, 0, 1 };
+    CHECK(accepts(Parser::TYPE_IPV4, "192.168.0.1", typed) && bytes(typed, v4, 4) && typed.mFamily == 4 && typed.mPrefix == 32);
+    CHECK(accepts(Parser::TYPE_IPV4, "0.0.0.0"));
+    CHECK(accepts(Parser::TYPE_IPV4, "255.255.255.255"));
+    const char* badV4[] = { "", "256.0.0.1", "1.2.3", "1.2.3.4.5", "01.2.3.4", "1.2.3.4 ", "1..2.3", "::1", "a.b.c.d" };
+    for (const char* value : badV4)
+        CHECK(!accepts(Parser::TYPE_IPV4, value));
+
+    // IPv6
+    static const unsigned char loopback[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+    static const unsigned char mapped[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 192, 0, 2, 1 };
+    static const unsigned char full[16] = { 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0, 7, 0xab, 0xcd };
+    CHECK(accepts(Parser::TYPE_IPV6, "::1", typed) && bytes(typed, loopback, 16) && typed.mFamily == 6 && typed.mPrefix == 128);
+    CHECK(accepts(Parser::TYPE_IPV6, "::ffff:192.0.2.1", typed) && bytes(typed, mapped, 16));
+    CHECK(accepts(Parser::TYPE_IPV6, "1:2:3:4:5:6:7:ABcd", typed) && bytes(typed, full, 16));
+    CHECK(accepts(Parser::TYPE_IPV6, "::"));
+    CHECK(accepts(Parser::TYPE_IPV6, "1::"));
+    CHECK(accepts(Parser::TYPE_IPV6, "2001:db8::ff00:42:8329"));
+    const char* badV6[] = { "", ":", ":::", ":1", "1:", "1::2::3", "12345::", "g::", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7::8", "1:2:3:4:5:6:7", "::1.2.3", "1.2.3.4" };
+    for (const char* value : badV6)
+        CHECK(!accepts(Parser::TYPE_IPV6, value));
+
+    // Either family
+    CHECK(accepts(Parser::TYPE_IPV4 | Parser::TYPE_IPV6, "10.0.0.1", typed) && typed.mFamily == 4);
+    CHECK(accepts(Parser::TYPE_IPV4 | Parser::TYPE_IPV6, "fe80::1", typed) && typed.mFamily == 6);
+    CHECK(!accepts(Parser::TYPE_IPV4 | Parser::TYPE_IPV6, "example.com"));
+
+    // CIDR
+    static const unsigned char net[] = { 10, 0, 0, 0 };
+    CHECK(accepts(Parser::TYPE_CIDR, "10.0.0.0/8", typed) && bytes(typed, net, 4) && typed.mFamily == 4 && typed.mPrefix == 8);
+    CHECK(accepts(Parser::TYPE_CIDR, "2001:db8::/32", typed) && typed.mFamily == 6 && typed.mPrefix == 32);
+    CHECK(accepts(Parser::TYPE_CIDR, "0.0.0.0/0"));
+    CHECK(accepts(Parser::TYPE_CIDR, "::/128"));
+    const char* badCidr[] = { "", "10.0.0.0", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08", "10.0.0.0/-1", "::/129", "/8", "10.0.0/8" };
+    for (const char* value : badCidr)
+        CHECK(!accepts(Parser::TYPE_CIDR, value));
+
+    // Port
+    CHECK(accepts(Parser::TYPE_PORT, "0", typed) && typed.mPort == 0);
+    CHECK(accepts(Parser::TYPE_PORT, "8080", typed) && typed.mPort == 8080);
+    CHECK(accepts(Parser::TYPE_PORT, "65535", typed) && typed.mPort == 65535);
+    const char* badPort[] = { "", "65536", "080", "-1", "+1", "123456", "80a", " 80" };
+    for (const char* value : badPort)
+        CHECK(!accepts(Parser::TYPE_PORT, value));
+
+    // UUID
+    static const unsigned char uuid[16] = { 0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3, 0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00 };
+    CHECK(accepts(Parser::TYPE_UUID, "123e4567-e89b-12d3-a456-426614174000", typed) && bytes(typed, uuid, 16));
+    CHECK(accepts(Parser::TYPE_UUID, "123E4567-E89B-12D3-A456-426614174000", typed) && bytes(typed, uuid, 16));
+    const char* badUuid[] = { "", "123e4567e89b12d3a456426614174000", "123e4567-e89b-12d3-a456-42661417400", "123e4567-e89b-12d3-a456-4266141740000",
+        "123e4567-e89b-12d3a-456-426614174000", "123e4567-e89b-12d3-a456-42661417400g", "{23e4567-e89b-12d3-a456-426614174000" };
+    for (const char* value : badUuid)
+        CHECK(!accepts(Parser::TYPE_UUID, value));
+
+    // MAC
+    static const unsigned char mac[] = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e };
+    CHECK(accepts(Parser::TYPE_MAC, "00:1A:2b:3c:4D:5e", typed) && bytes(typed, mac, 6));
+    CHECK(accepts(Parser::TYPE_MAC, "00-1a-2b-3c-4d-5e", typed) && bytes(typed, mac, 6));
+    const char* badMac[] = { "", "00:1a:2b:3c:4d", "00:1a-2b:3c:4d:5e", "00.1a.2b.3c.4d.5e", "0g:1a:2b:3c:4d:5e", "00:1a:2b:3c:4d:5e:", "001a2b3c4d5e" };
+    for (const char* value : badMac)
+        CHECK(!accepts(Parser::TYPE_MAC, value));
+
+    // Timestamps
+    CHECK(seconds("1970-01-01T00:00:00Z", 0));
+    CHECK(seconds("2000-02-29", 951782400));
+    CHECK(seconds("1600-03-01", -11670912000ll));
+    CHECK(seconds("1985-04-12T23:20:50.52Z", 482196050, 520000000));
+    CHECK(seconds("1985-04-12t23:20:50.123456789z", 482196050, 123456789));
+    CHECK(seconds("1985-04-12 23:20:50Z", 482196050));
+    CHECK(seconds("1996-12-19T16:39:57-08:00", 851042397));
+    CHECK(seconds("1970-01-01T00:00:00+05:30", -19800));
+    // Leap seconds, as in RFC 3339 section 5.8, land on the next minute.
+    CHECK(seconds("2016-12-31T23:59:60Z", 1483228800));
+    CHECK(seconds("1990-12-31T15:59:60-08:00", 662688000));
+    CHECK(seconds("1990-12-31T23:59:60.5Z", 662688000, 500000000));
+    const char* badTime[] = { "", "2000-1-01", "2001-02-29", "1900-02-29", "2000-13-01", "2000-00-10", "2000-04-31", "2000-01-00",
+        "2000-01-01T", "2000-01-01T00:00:00", "2000-01-01X00:00:00Z", "2000-01-01T24:00:00Z", "2000-01-01T00:60:00Z",
+        "2000-01-01T00:00:61Z", "2000-01-01T00:00:00.Z", "2000-01-01T00:00:00.1234567890Z", "2000-01-01T00:00:00+24:00",
+        "2000-01-01T00:00:00+05:60", "2000-01-01T00:00:00+0530", "2000-01-01T00:00:00ZZ", "2000-01-01T0:00:00Z" };
+    for (const char* value : badTime)
+        CHECK(!accepts(Parser::TYPE_TIMESTAMP, value));
+
+    // A rejected value leaves typed() empty, however far parsing got and
+    // whatever an earlier parse had stored.
+    std::ostringstream sink;
+    Parser parser("test");
+    parser.setStreams(sink, sink);
+    parser.addOptions({
+        {{"--ip"}, "Address.", false, {{"value", "The address.", Parser::TYPE_IPV4}}},
+        {{"--net"}, "Network.", false, {{"value", "The network.", Parser::TYPE_CIDR}}},
+        {{"--mac"}, "MAC.", false, {{"value", "The MAC.", Parser::TYPE_MAC}}},
+        {{"--at"}, "Time.", false, {{"value", "The time.", Parser::TYPE_TIMESTAMP}}},
+    });
+    const char* good[] = { "test", "--ip", "1.2.3.4", "--net", "10.0.0.0/8", "--mac", "00:1a:2b:3c:4d:5e", "--at", "2000-01-01T00:00:00.5Z" };
+    CHECK(parser.parse(9, const_cast<char**>(good)) == Parser::PARSED_OK);
+    CHECK(!empty(parser("--ip").typed("value")) && !empty(parser("--at").typed("value")));
+
+    const char* badIp[] = { "test", "--ip", "1.2.3.400" };
+    CHECK(parser.parse(3, const_cast<char**>(badIp)) == Parser::PARSED_FAILED_VALIDATOR);
+    CHECK(empty(parser("--ip").typed("value")));
+    const char* badNet[] = { "test", "--net", "10.0.0.0/40" };
+    CHECK(parser.parse(3, const_cast<char**>(badNet)) == Parser::PARSED_FAILED_VALIDATOR);
+    CHECK(empty(parser("--net").typed("value")));
+    const char* badMacValue[] = { "test", "--mac", "00:1a:2b:3c:4d:zz" };
+    CHECK(parser.parse(3, const_cast<char**>(badMacValue)) == Parser::PARSED_FAILED_VALIDATOR);
+    CHECK(empty(parser("--mac").typed("value")));
+    const char* badAt[] = { "test", "--at", "2000-01-01T00:00:00.5" };
+    CHECK(parser.parse(3, const_cast<char**>(badAt)) == Parser::PARSED_FAILED_VALIDATOR);
+    CHECK(empty(parser("--at").typed("value")));
+    CHECK(sink.str().find("Invalid timestamp value in argument {'value'} for parameter '--at'") != std::string::npos);
+    TEST_END();
+}
@@ -0,0 +1,99 @@
+#include "cli_parser.h"
+#include "test.h"
+
+#include <random>
+
+// Straightforward UTF-8 and control character rules the vectorized checks
+// must agree with.
+static bool referenceCheck(const std::string& value, unsigned checks)
+{
+    bool utf8 = (checks & cli::Parser::CHECK_UTF8) != 0;
+    bool noControl = (checks & cli::Parser::CHECK_NO_CONTROL) != 0;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(value.data());
+    size_t length = value.size();
+
+    for (size_t i = 0; i < length;)
+    {
+        unsigned c = data[i];
+        if (c < 0x80)
+        {
+            if (noControl && (c < 0x20 || c == 0x7F))
+                return false;
+            ++i;
+            continue;
+        }
+        if (!utf8)
+        {
+            if (noControl && c == 0xC2 && i + 1 < length && data[i + 1] >= 0x80 && data[i + 1] < 0xA0)
+                return false;
+            ++i;
+            continue;
+        }
+
+        size_t extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        if (extra == 0 || c > 0xF4 || i + extra >= length)
+            return false;
+
+        unsigned cp = c & (0x3F >> extra);
+        for (size_t k = 1; k <= extra; ++k)
+        {
+            if ((data[i + k] & 0xC0) != 0x80)
+                return false;
+            cp = cp << 6 | (data[i + k] & 0x3F);
+        }
+
+        static const unsigned minimum[] = { 0, 0x80, 0x800, 0x10000 };
+        if (cp < minimum[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return false;
+        if (noControl && cp >= 0x80 && cp < 0xA0)
+            return false;
+        i += extra + 1;
+    }
+    return true;
+}
+
+int main()
+{
+    std::ostringstream sink;
+    const unsigned masks[] = { cli::Parser::CHECK_UTF8, cli::Parser::CHECK_NO_CONTROL, cli::Parser::CHECK_UTF8 | cli::Parser::CHECK_NO_CONTROL };
+    cli::Parser parsers[3];
+    for (int m = 0; m < 3; ++m)
+    {
+        parsers[m].setStreams(sink, sink);
+        parsers[m].addOptions({
+            {{"--value"}, "Checked value.", false, {{"value", "The value.", masks[m]}}},
+        });
+    }
+
+    std::mt19937 random(88);
+    const char* const pieces[] = { "a", " ", "\x7F", "\x01", "\xC2\x85", "\xC2\xA0", "\xC3\xA9", "\xE2\x82\xAC", "\xED\xA0\x80", "\xF0\x9F\x98\x80", "\xF4\x90\x80\x80", "\xC0\xAF", "\xE0\x80\xAF", "\x80", "\xFF" };
+    int mismatches = 0;
+    for (int n = 0; n < 50000; ++n)
+    {
+        // Long ASCII runs reach the 16-byte blocks; pieces land at every offset.
+        std::string value(random() % 40, 'x');
+        for (size_t count = random() % 6; count > 0; --count)
+            value.insert(random() % (value.size() + 1), pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))]);
+        if (random() % 4 == 0 && !value.empty())
+            value[random() % value.size()] = static_cast<char>(1 + random() % 255);
+
+        for (int m = 0; m < 3; ++m)
+        {
+            const char* argv[] = { "test", "--value", value.c_str() };
+            bool accepted = parsers[m].parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK;
+            if (accepted != referenceCheck(value, masks[m]) && ++mismatches <= 10)
+                std::fprintf(stderr, "mismatch for mask %u on %zu bytes\n", masks[m], value.size());
+        }
+    }
+    CHECK(mismatches == 0);
+
+    // Values of arguments without encoding checks are accepted as they are.
+    cli::Parser plain;
+    plain.setStreams(sink, sink);
+    plain.addOptions({
+        {{"--path"}, "A path.", false, {{"path", "The path.", cli::Parser::FILE_PATH}}},
+    });
+    const char* argv[] = { "test", "--path", "\xFF\x01" };
+    CHECK(plain.parse(3, const_cast<char**>(argv)) == cli::Parser::PARSED_OK);
+    TEST_END();
+}